@@ -0,0 +1,345 @@
+/* Name : Nikhitha Palakurla
+Project Name and Description : Sequence Project
+contiguous gap-buffer backend exposing the same interface as the linked
+Sequence, for read-mostly workloads that need O(1) random access */
+
+#include "GapSequence.h"  // Include class definition
+#include <algorithm>      // Provides std::move, std::move_backward, std::min
+#include <cstring>        // Provides std::memcpy, std::memset
+#include <limits>         // Provides std::numeric_limits
+
+#if defined(__SSE2__)
+#include <emmintrin.h>    // SSE2 intrinsics for the packed-key scans
+#endif
+
+// ============================================================================
+// Packed keys - the first 8 bytes of an item packed into one integer so that
+// prefix and equality tests become integer compares over flat arrays
+// ============================================================================
+std::uint64_t GapSequence::packPrefix(const std::string& s, size_t count) {
+    unsigned char bytes[8] = {0};                   // Zero padding for short items
+    std::memcpy(bytes, s.data(), std::min({s.size(), count, sizeof(bytes)}));
+    std::uint64_t key;
+    std::memcpy(&key, bytes, sizeof(key));          // Byte order matches prefixMask
+    return key;
+}
+
+std::uint64_t GapSequence::prefixMask(size_t count) {
+    unsigned char bytes[8] = {0};
+    std::memset(bytes, 0xFF, std::min(count, sizeof(bytes))); // Select the leading count bytes
+    std::uint64_t mask;
+    std::memcpy(&mask, bytes, sizeof(mask));
+    return mask;
+}
+
+void GapSequence::refreshKey(size_t slot) const {
+    const std::string& item = items[slot];
+    prefixes[slot] = packPrefix(item, 8);
+    lengths[slot] = static_cast<std::uint32_t>(
+        std::min<size_t>(item.size(), std::numeric_limits<std::uint32_t>::max()));
+}
+
+void GapSequence::refreshKeys() const {
+    if (allDirty) {                                 // Recompute every element slot
+        for (size_t slot = 0; slot < gapStart; ++slot) refreshKey(slot);
+        for (size_t slot = gapEnd; slot < capacity(); ++slot) refreshKey(slot);
+    } else {
+        for (size_t slot : dirty) refreshKey(slot); // Only slots written through operator[]
+    }
+}
+
+void GapSequence::releaseSlots() {
+    refreshKeys();                                  // Keep what was written so far
+    dirty.clear();                                  // Slot numbers are about to change, and
+    allDirty = false;                               // the references with them
+}
+
+// ============================================================================
+// Gap management
+// ============================================================================
+size_t GapSequence::physical(size_t position) const {
+    return position < gapStart ? position : position + (gapEnd - gapStart); // Skip over the gap
+}
+
+size_t GapSequence::capacity() const {
+    return items.size();
+}
+
+void GapSequence::moveGap(size_t position) {
+    releaseSlots();                                 // Outstanding references end here
+    if (gapStart == gapEnd) {                       // Empty gap: nothing to shift (and no self-moves)
+        gapStart = gapEnd = position;
+    } else if (position < gapStart) {                      // Shift elements [position, gapStart) right
+        size_t count = gapStart - position;
+        std::move_backward(items.begin() + position, items.begin() + gapStart, items.begin() + gapEnd);
+        std::move_backward(prefixes.begin() + position, prefixes.begin() + gapStart, prefixes.begin() + gapEnd);
+        std::move_backward(lengths.begin() + position, lengths.begin() + gapStart, lengths.begin() + gapEnd);
+        gapStart -= count;
+        gapEnd -= count;
+    } else if (position > gapStart) {               // Shift elements after the gap left
+        size_t count = position - gapStart;
+        std::move(items.begin() + gapEnd, items.begin() + gapEnd + count, items.begin() + gapStart);
+        std::move(prefixes.begin() + gapEnd, prefixes.begin() + gapEnd + count, prefixes.begin() + gapStart);
+        std::move(lengths.begin() + gapEnd, lengths.begin() + gapEnd + count, lengths.begin() + gapStart);
+        gapStart += count;
+        gapEnd += count;
+    }
+}
+
+void GapSequence::reserveGap(size_t needed) {
+    if (gapEnd - gapStart >= needed)                // Enough room already
+        return;
+
+    size_t oldCapacity = capacity();
+    size_t newCapacity = std::max({oldCapacity * 2, size() + needed, size_t(8)}); // Geometric growth
+    size_t grow = newCapacity - oldCapacity;
+
+    items.resize(newCapacity);                      // Open new slots at the end, then move the
+    prefixes.resize(newCapacity);                   // segment after the gap up to the new end
+    lengths.resize(newCapacity);
+    std::move_backward(items.begin() + gapEnd, items.begin() + oldCapacity, items.end());
+    std::move_backward(prefixes.begin() + gapEnd, prefixes.begin() + oldCapacity, prefixes.end());
+    std::move_backward(lengths.begin() + gapEnd, lengths.begin() + oldCapacity, lengths.end());
+    gapEnd += grow;
+}
+
+void GapSequence::setSlot(size_t slot, std::string item) {
+    items[slot] = std::move(item);
+    refreshKey(slot);
+}
+
+// ============================================================================
+// Constructors / Destructor / Assignment
+// ============================================================================
+GapSequence::GapSequence(size_t sz)
+    : items(sz), prefixes(sz, 0), lengths(sz, 0), gapStart(sz), gapEnd(sz), dirty(), allDirty(false) {
+}
+
+GapSequence::GapSequence(const GapSequence& s)
+    : items(), prefixes(), lengths(), gapStart(0), gapEnd(0), dirty(), allDirty(false) {
+    *this = s;                                      // Reuse assignment's deep copy
+}
+
+GapSequence::~GapSequence() {
+    clear();                                        // Release all storage on destruction
+}
+
+GapSequence& GapSequence::operator=(const GapSequence& s) {
+    if (this != &s) {                               // Avoid self-assignment
+        s.refreshKeys();                            // Copy up-to-date keys
+        items = s.items;
+        prefixes = s.prefixes;
+        lengths = s.lengths;
+        gapStart = s.gapStart;
+        gapEnd = s.gapEnd;
+        dirty.clear();
+        allDirty = false;
+    }
+    return *this;                                   // Enable assignment chaining
+}
+
+// ============================================================================
+// Element Access
+// ============================================================================
+std::string& GapSequence::operator[](size_t position) {
+    if (position >= size())                         // Validate index bounds
+        throw std::out_of_range("Invalid index");
+
+    size_t slot = physical(position);
+    if (!allDirty && (dirty.empty() || dirty.back() != slot)) { // Caller may write through the reference
+        if (dirty.size() >= 64 && dirty.size() > size() / 8) {
+            dirty.clear();                          // Cheaper to refresh everything later
+            allDirty = true;
+        } else {
+            dirty.push_back(slot);
+        }
+    }
+    return items[slot];
+}
+
+const std::string& GapSequence::at(size_t position) const {
+    if (position >= size())                         // Validate index bounds
+        throw std::out_of_range("Invalid index");
+    return items[physical(position)];
+}
+
+// ============================================================================
+// Modifiers
+// ============================================================================
+void GapSequence::push_back(std::string item) {
+    insert(size(), std::move(item));               // Gap stays at the end for repeated appends
+}
+
+void GapSequence::pop_back() {
+    if (empty())                                   // Prevent pop on empty sequence
+        throw std::runtime_error("Cannot pop_back from empty sequence");
+    erase(size() - 1, 1);
+}
+
+void GapSequence::insert(size_t position, std::string item) {
+    if (position > size())                         // Validate insert index
+        throw std::out_of_range("Invalid index for insert");
+
+    moveGap(position);                             // Edit point moves to position
+    reserveGap(1);
+    setSlot(gapStart, std::move(item));            // Fill the first gap slot
+    ++gapStart;
+}
+
+void GapSequence::clear() {
+    items.clear();                                 // Release all storage
+    prefixes.clear();
+    lengths.clear();
+    gapStart = gapEnd = 0;
+    dirty.clear();
+    allDirty = false;
+}
+
+void GapSequence::erase(size_t position) {
+    erase(position, 1);                            // Delegate to range erase
+}
+
+void GapSequence::erase(size_t position, size_t count) {
+    if (position >= size())                        // Validate starting index
+        throw std::out_of_range("Invalid erase position");
+    if (count == 0)                                // Nothing to remove
+        return;
+    if (count > size() - position)                 // Ensure range is valid (no overflow)
+        throw std::out_of_range("Invalid erase range");
+
+    moveGap(position);                             // Removed slots now follow the gap
+    for (size_t slot = gapEnd; slot < gapEnd + count; ++slot)
+        items[slot] = std::string();               // Release their memory
+    gapEnd += count;                               // Swallow them into the gap
+}
+
+// ============================================================================
+// Accessors
+// ============================================================================
+std::string GapSequence::front() const {
+    if (empty()) throw std::runtime_error("Sequence is empty"); // Check nonempty
+    return items[physical(0)];
+}
+
+std::string GapSequence::back() const {
+    if (empty()) throw std::runtime_error("Sequence is empty"); // Check nonempty
+    return items[physical(size() - 1)];
+}
+
+bool GapSequence::empty() const {
+    return size() == 0;
+}
+
+size_t GapSequence::size() const {
+    return capacity() - (gapEnd - gapStart);        // Every slot outside the gap is an element
+}
+
+// ============================================================================
+// Scans - candidates are found by comparing packed keys (4 slots per step with
+// SSE2) and then confirmed against the full strings
+// ============================================================================
+#if defined(__SSE2__)
+// Two-bit mask of which 64-bit lanes of a and b are equal (SSE2 has no 64-bit compare)
+static inline int equalLanes64(__m128i a, __m128i b) {
+    __m128i eq32 = _mm_cmpeq_epi32(a, b);
+    __m128i both = _mm_and_si128(eq32, _mm_shuffle_epi32(eq32, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_movemask_pd(_mm_castsi128_pd(both));
+}
+#endif
+
+template <typename Match>
+bool GapSequence::scan(size_t begin, size_t end, std::uint64_t key, std::uint64_t mask, std::uint32_t length,
+                       bool matchLength, Match&& onCandidate) const {
+    size_t slot = begin;
+#if defined(__SSE2__)
+    const __m128i keys = _mm_set1_epi64x(static_cast<long long>(key));
+    const __m128i masks = _mm_set1_epi64x(static_cast<long long>(mask));
+    const __m128i lens = _mm_set1_epi32(static_cast<int>(length));
+    for (; slot + 4 <= end; slot += 4) {
+        __m128i low = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&prefixes[slot])), masks);
+        __m128i high = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&prefixes[slot + 2])), masks);
+        int hits = equalLanes64(low, keys) | (equalLanes64(high, keys) << 2);
+        if (matchLength) {
+            __m128i sizes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&lengths[slot]));
+            hits &= _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(sizes, lens)));
+        }
+        for (int lane = 0; hits; ++lane, hits >>= 1)
+            if ((hits & 1) && onCandidate(slot + lane))
+                return true;
+    }
+#endif
+    for (; slot < end; ++slot) {                    // Remainder (or whole range without SSE2)
+        if ((prefixes[slot] & mask) == key && (!matchLength || lengths[slot] == length)
+            && onCandidate(slot))
+            return true;
+    }
+    return false;
+}
+
+size_t GapSequence::find(const std::string& item, size_t from) const {
+    refreshKeys();
+    std::uint64_t key = packPrefix(item, 8);
+    std::uint32_t length = static_cast<std::uint32_t>(
+        std::min<size_t>(item.size(), std::numeric_limits<std::uint32_t>::max()));
+    size_t found = npos;
+    auto confirm = [&](size_t slot) {               // Full compare only for key matches
+        if (items[slot] != item) return false;
+        found = slot < gapStart ? slot : slot - (gapEnd - gapStart);
+        return true;
+    };
+
+    if (from < gapStart && scan(from, gapStart, key, ~std::uint64_t(0), length, true, confirm))
+        return found;
+    scan(physical(std::max(from, gapStart)), capacity(), key, ~std::uint64_t(0), length, true, confirm);
+    return found;
+}
+
+std::vector<size_t> GapSequence::positions_with_length(size_t length) const {
+    refreshKeys();
+    std::vector<size_t> positions;
+    std::uint32_t packed = static_cast<std::uint32_t>(
+        std::min<size_t>(length, std::numeric_limits<std::uint32_t>::max()));
+    auto collect = [&](size_t slot) {
+        if (items[slot].size() == length)           // Only differs from packed when saturated
+            positions.push_back(slot < gapStart ? slot : slot - (gapEnd - gapStart));
+        return false;
+    };
+    scan(0, gapStart, 0, 0, packed, true, collect);
+    scan(gapEnd, capacity(), 0, 0, packed, true, collect);
+    return positions;
+}
+
+std::vector<size_t> GapSequence::positions_with_prefix(const std::string& prefix) const {
+    refreshKeys();
+    std::vector<size_t> positions;
+    std::uint64_t key = packPrefix(prefix, 8);
+    std::uint64_t mask = prefixMask(prefix.size());
+    auto collect = [&](size_t slot) {               // Confirms length and bytes past the first 8
+        const std::string& item = items[slot];
+        if (item.size() >= prefix.size() && item.compare(0, prefix.size(), prefix) == 0)
+            positions.push_back(slot < gapStart ? slot : slot - (gapEnd - gapStart));
+        return false;
+    };
+    scan(0, gapStart, key, mask, 0, false, collect);
+    scan(gapEnd, capacity(), key, mask, 0, false, collect);
+    return positions;
+}
+
+// Output operator - prints formatted contents of sequence
+
+std::ostream& operator<<(std::ostream& os, const GapSequence& s) {
+    os << "<";                                   // Begin list formatting
+    bool first = true;                           // Track comma placement
+
+    for (size_t i = 0; i < s.size(); ++i) {      // Traverse all elements
+        const std::string& item = s.items[s.physical(i)];
+        if (!item.empty()) {                     // Skip empty strings
+            if (!first) os << ", ";              // Add comma after first element
+            os << item;                          // Output current item
+            first = false;                       // Mark first printed
+        }
+    }
+
+    os << ">";                                   // Close list formatting
+    return os;                                   // Return output stream
+}
@@ -0,0 +1,87 @@
+#ifndef GAP_SEQUENCE_H
+#define GAP_SEQUENCE_H
+
+#include <cstdint>                  // Provides fixed-width integer types
+#include <iostream>
+#include <string>                   // Provides std::string class
+#include <stdexcept>                // Provides exception classes (runtime_error, out_of_range)
+#include <vector>                   // Provides contiguous storage
+// GapSequence - Contiguous Sequence backend built on a gap buffer
+//
+// Shares Sequence's core interface (element access, push_back/pop_back,
+// insert, erase, clear, front/back and the scans), so callers of just that
+// subset pick a backend per workload by picking the type. It has no
+// push_front/pop_front, moves, append, capacity limit, reverse/rotate,
+// sorting or transactions. Elements live in one flat array with a movable
+// gap at the last edit point: random access is O(1) and inserts/erases near
+// the previous edit are amortized O(1). Each slot also keeps a packed length
+// and an 8-byte prefix so equality and length/prefix scans run with SIMD over
+// plain integer arrays and only touch the strings of likely matches.
+//
+// References returned by operator[] are invalidated by insert, erase,
+// push_back and pop_back, like std::vector references. Until then writes
+// through them are seen by every later scan, which costs each scan a key
+// refresh per handed-out slot; read through at() to avoid that.
+
+class GapSequence {
+private:
+    std::vector<std::string> items;                 // Element storage, gap included
+    mutable std::vector<std::uint64_t> prefixes;    // First 8 bytes of each item, zero padded
+    mutable std::vector<std::uint32_t> lengths;     // Item lengths (saturated at UINT32_MAX)
+    size_t gapStart;                                // First physical slot of the gap
+    size_t gapEnd;                                  // One past the last physical slot of the gap
+    std::vector<size_t> dirty;                      // Physical slots handed out by operator[] since the last edit
+    bool allDirty;                          // Too many handouts: refresh every slot
+
+    size_t physical(size_t position) const;         // Maps logical index to storage slot
+    size_t capacity() const;                        // Number of physical slots
+    void moveGap(size_t position);                  // Moves the gap so it starts at position
+    void reserveGap(size_t needed);                 // Grows storage so the gap holds needed slots
+    void setSlot(size_t slot, std::string item);    // Stores item and its packed key
+    void refreshKey(size_t slot) const;             // Recomputes packed key from the stored item
+    void refreshKeys() const;                       // Applies operator[] writes to the keys (slots stay dirty)
+    void releaseSlots();                            // Refreshes keys and forgets the slots before an edit
+    template <typename Match>
+    bool scan(size_t begin, size_t end, std::uint64_t key, std::uint64_t mask, std::uint32_t length,
+              bool matchLength, Match&& onCandidate) const; // Vectorized prefix/length scan of slots [begin, end)
+
+    static std::uint64_t packPrefix(const std::string& s, size_t count); // Packs up to 8 leading bytes
+    static std::uint64_t prefixMask(size_t count);  // Mask selecting the first count packed bytes
+
+public:
+    static const size_t npos = static_cast<size_t>(-1); // Returned by find when nothing matches
+
+    // Constructors / Destructor
+    GapSequence(size_t sz = 0);                     // Creates sequence with sz empty strings
+    GapSequence(const GapSequence& s);              // Copy constructor creates deep copy
+    ~GapSequence();                                 // Destructor releases all resources
+    GapSequence& operator=(const GapSequence& s);   // Assignment operator performs deep copy
+
+    // Element access
+    std::string& operator[](size_t position);       // Provides read/write access to element at index
+    const std::string& at(size_t position) const;   // Read-only access to element at index (keys stay clean)
+
+    // Modifiers
+    void push_back(std::string item);               // Adds new element to end
+    void pop_back();                                // Removes last element
+    void insert(size_t position, std::string item); // Inserts element at given index
+    void clear();                                   // Removes all elements
+    void erase(size_t position);                    // Removes single element at index
+    void erase(size_t position, size_t count);      // Removes multiple elements starting at index
+
+    // Accessors
+    std::string front() const;                      // Returns first element (throws if empty)
+    std::string back() const;                       // Returns last element (throws if empty)
+    bool empty() const;                             // Checks if sequence contains no elements
+    size_t size() const;                            // Returns current number of elements
+
+    // Scans
+    size_t find(const std::string& item, size_t from = 0) const;              // Index of first equal item at or after from
+    std::vector<size_t> positions_with_length(size_t length) const;           // Indices of items with the given length
+    std::vector<size_t> positions_with_prefix(const std::string& prefix) const; // Indices of items starting with prefix
+
+    // Output
+    friend std::ostream& operator<<(std::ostream& os, const GapSequence& s); // Prints formatted list to output stream
+};
+
+#endif // GAP_SEQUENCE_H
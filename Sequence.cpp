@@ -4,126 +4,536 @@ construct a Sequence class that supports random access like an array, but also
 allows dynamic insertion and removal of new elements */
 
 #include "Sequence.h"  // Include class and node definitions
+#include <algorithm>   // Provides std::min, std::max, std::find, std::remove
+
+// Trace builds record every public call (see SequenceTrace.h); nested calls are skipped
+#ifdef SEQUENCE_TRACE
+#include "SequenceTrace.h"
+#define SEQUENCE_RECORD(...) SequenceTrace::Scope traceScope; \
+    if (traceScope.outer()) SequenceTrace::record(__VA_ARGS__)
+#define SEQUENCE_TRACK(item) if (traceScope.outer()) SequenceTrace::trackStore(this, item)
+#define SEQUENCE_RECORD_MOVE(source) SequenceTrace::Scope traceScope; \
+    if (traceScope.outer()) SequenceTrace::recordMove(this, &source)
+#define SEQUENCE_RECORD_SNAPSHOT(snap) SequenceTrace::Scope traceScope; \
+    if (traceScope.outer()) SequenceTrace::recordSnapshot(this, snap)
+#else
+#define SEQUENCE_RECORD(...) ((void)0)
+#define SEQUENCE_TRACK(item) ((void)0)
+#define SEQUENCE_RECORD_MOVE(source) ((void)0)
+#define SEQUENCE_RECORD_SNAPSHOT(snap) ((void)0)
+#endif
+
+// ============================================================================
+// Chain helpers - slots that were never written are kept as "gap" nodes, each
+// standing for a run of empty strings. Gaps are split only when a slot inside
+// them is accessed through operator[] or an insert lands in their middle.
+// ============================================================================
+std::shared_ptr<SequenceNode> Sequence::makeGap(size_t count) {
+    auto node = std::make_shared<SequenceNode>();   // Gap nodes carry no item
+    node->gap = count;                              // Remember how many slots it covers
+    return node;
+}
+
+void Sequence::appendNode(const std::shared_ptr<SequenceNode>& node) {
+    if (!head) {                                   // If list is empty
+        head = node;                               // New node becomes head
+        tail = node;                               // And also the tail
+    } else {
+        auto tailPtr = tail.lock();                // Get strong ref to current tail
+        tailPtr->next = node;                      // Link new node after tail
+        node->prev = tailPtr;                      // Set back link to old tail
+        tail = node;                               // Update tail pointer
+    }
+}
+
+void Sequence::linkAfter(const std::shared_ptr<SequenceNode>& node, const std::shared_ptr<SequenceNode>& newNode) {
+    newNode->next = node->next;                    // Take over node's successor
+    newNode->prev = node;                          // Link back to node
+    if (newNode->next)
+        newNode->next->prev = newNode;             // Successor now points back at newNode
+    else
+        tail = newNode;                            // newNode is the new tail
+    node->next = newNode;                          // Link node forward to newNode
+}
+
+void Sequence::linkBefore(const std::shared_ptr<SequenceNode>& node, const std::shared_ptr<SequenceNode>& newNode) {
+    auto prevNode = node->prev.lock();             // Node currently before node
+    if (prevNode) {
+        linkAfter(prevNode, newNode);              // Same as linking after the predecessor
+        return;
+    }
+    newNode->next = node;                          // newNode becomes the head
+    node->prev = newNode;
+    head = newNode;
+}
+
+void Sequence::unlink(const std::shared_ptr<SequenceNode>& node) {
+    auto prevNode = node->prev.lock();             // Access previous node
+    auto nextNode = node->next;                    // Access next node
+
+    if (prevNode)
+        prevNode->next = nextNode;                 // Skip over removed node
+    else
+        head = nextNode;                           // Update head if first removed
+
+    if (nextNode)
+        nextNode->prev = prevNode;                 // Reconnect backward link
+    else
+        tail = prevNode;                           // Update tail if last removed
+
+    node->next.reset();                            // Detach removed node completely
+    node->prev.reset();
+}
 
 // ============================================================================
-// getNode - returns pointer to node at a given position
+// findNode - returns the node covering a position and the offset inside it
 // ============================================================================
-std::shared_ptr<SequenceNode> Sequence::getNode(size_t position) const {
+std::shared_ptr<SequenceNode> Sequence::findNode(size_t position, size_t& offset) const {
     if (position >= numElts)                        // Validate index bounds
         throw std::out_of_range("Invalid index");   // Throw if out of range
 
-    auto current = head;                            // Start from head node
-    for (size_t i = 0; i < position; ++i)           // Traverse forward to target node
-        current = current->next;
+    if (posIndexed) {                               // Indexed: no walking at all
+        size_t i = position;
+        if (posNodes.size() != numElts)             // Gaps present: search node starts
+            i = std::upper_bound(posStarts.begin(), posStarts.end(), position) - posStarts.begin() - 1;
+        offset = position - posStarts[i];
+        return posNodes[i];
+    }
+
+    std::shared_ptr<SequenceNode> current;
+    size_t steps = 0;
+    // Stepping back through weak prev links costs a lock per node, so walk
+    // backward only when the tail is a lot closer than the head
+    if ((numElts - position) * 3 > position) {      // Walk forward from the head
+        const std::shared_ptr<SequenceNode>* link = &head; // Owning pointer: no refcount traffic per step
+        while (position >= (*link)->span()) {       // Skip whole nodes (gaps count as many slots)
+            position -= (*link)->span();
+            link = &(*link)->next;
+            ++steps;
+        }
+        current = *link;
+        offset = position;                          // Slot inside the located node
+    } else {                                        // Walk backward from the tail
+        current = tail.lock();
+        size_t start = numElts - current->span();   // First slot of current
+        while (position < start) {
+            current = current->prev.lock();
+            start -= current->span();
+            ++steps;
+        }
+        offset = position - start;
+    }
+
+    walkCost += steps;                              // Reads now cost more than indexing would
+#ifndef SEQUENCE_LINKED_ONLY
+    if (walkCost > 2 * numElts && numElts >= 64)
+        buildPositions();
+#endif
     return current;                                 // Return located node
 }
 
+void Sequence::buildPositions() const {
+    posNodes.clear();
+    posStarts.clear();
+    size_t start = 0;
+    for (auto current = head; current; current = current->next) {
+        posNodes.push_back(current);
+        posStarts.push_back(start);
+        start += current->span();
+    }
+    posIndexed = true;
+}
+
+void Sequence::dropPositions() {
+    walkCost = 0;                                   // Start sampling the new mix afresh
+    if (!posIndexed) return;
+    posNodes.clear();
+    posStarts.clear();
+    posIndexed = false;
+}
+
 // ============================================================================
-// Constructors / Destructor / Assignment
+// getNode - returns the real node at a given position, splitting a gap so the
+// requested slot gets its own node
 // ============================================================================
-Sequence::Sequence(size_t sz) : head(nullptr), tail(), numElts(0) {
-    for (size_t i = 0; i < sz; ++i)                 // Create sz empty nodes if requested
-        push_back("");
+std::shared_ptr<SequenceNode> Sequence::getNode(size_t position) {
+    size_t offset = 0;
+    size_t slot = physical(position);
+    auto node = findNode(slot, offset);             // Locate covering node
+    if (node->gap == 0)                             // Already a real element
+        return node;
+
+    size_t before = offset;                         // Empty slots left before the target
+    size_t after = node->gap - offset - 1;          // Empty slots left after the target
+    if (logging())                                  // Later undo entries rely on the original layout
+        logChange(UndoEntry::Kind::Resize, node, nullptr, node->gap);
+
+    // A split moves no slots, so the positional index only gains the new nodes
+    size_t at = 0;                                  // Index entry of node
+    if (posIndexed)
+        at = std::upper_bound(posStarts.begin(), posStarts.end(), slot) - posStarts.begin() - 1;
+    auto real = node;
+    if (before == 0) {                              // Target is the first slot: reuse node
+        node->gap = 0;
+    } else {
+        node->gap = before;                         // Node keeps the leading gap
+        real = std::make_shared<SequenceNode>();    // Materialize the target slot
+        linkAfter(node, real);
+        if (logging()) logChange(UndoEntry::Kind::Unlink, real);
+        if (posIndexed) {
+            ++at;
+            posNodes.insert(posNodes.begin() + at, real);
+            posStarts.insert(posStarts.begin() + at, slot);
+        }
+    }
+    if (after > 0) {                                // Trailing gap follows the target
+        auto rest = makeGap(after);
+        linkAfter(real, rest);
+        if (logging()) logChange(UndoEntry::Kind::Unlink, rest);
+        if (posIndexed) {
+            posNodes.insert(posNodes.begin() + at + 1, rest);
+            posStarts.insert(posStarts.begin() + at + 1, slot + 1);
+        }
+    }
+    return real;
 }
 
-Sequence::Sequence(const Sequence& s) : head(nullptr), tail(), numElts(0) {
-    auto node = s.head;                             // Start copying from source head
-    while (node) {                                  // Deep-copy each node
-        push_back(node->item);
-        node = node->next;
+// ============================================================================
+// Constructors / Destructor / Assignment
+// ============================================================================
+Sequence::Sequence(size_t sz)
+    : head(nullptr), tail(), numElts(0), indexed(false), logGeneration(0), assignOpen(false),
+      posIndexed(false), walkCost(0), maxElts(0), spareCount(0), reversed(false), rotation(0) {
+    SEQUENCE_RECORD(TraceOp::Construct, this, {sz});
+    if (sz > 0) {                                   // Represent sz empty slots with one gap node
+        appendNode(makeGap(sz));
+        numElts = sz;
     }
 }
 
+Sequence::Sequence(const Sequence& s)
+    : head(nullptr), tail(), numElts(0), indexed(false), logGeneration(0), assignOpen(false),
+      posIndexed(false), walkCost(0), maxElts(s.maxElts), spareCount(0), reversed(s.reversed),
+      rotation(s.rotation) {
+    SEQUENCE_RECORD(TraceOp::Copy, this, {SequenceTrace::idOf(&s)});
+    std::shared_ptr<SequenceNode> last;
+    head = s.copyChain(last);                       // Deep-copy each node (gaps stay gaps)
+    tail = last;
+    numElts = s.numElts;
+}
+
 Sequence::~Sequence() {
+    SEQUENCE_RECORD(TraceOp::Destroy, this);
+    discardLog(0);                                  // Open transactions die with the sequence
+    txMarks.clear();
     clear();                                        // Release all nodes on destruction
 }
 
 Sequence& Sequence::operator=(const Sequence& s) {
+    SEQUENCE_RECORD(TraceOp::CopyAssign, this, {SequenceTrace::idOf(&s)});
     if (this != &s) {                               // Avoid self-assignment
-        clear();                                    // Clear existing nodes
-        auto node = s.head;                         // Copy from source sequence
-        while (node) {
-            push_back(node->item);
-            node = node->next;
-        }
+        clear();                                    // Clear existing nodes (logged as one checkpoint)
+        std::shared_ptr<SequenceNode> last;
+        head = s.copyChain(last);                   // Copy from source sequence
+        tail = last;
+        numElts = s.numElts;
+        limit(s.maxElts);
+        orient(s.reversed, s.rotation);             // Same order as s without touching the copy
+    }
+    return *this;                                   // Enable assignment chaining
+}
+
+Sequence::Sequence(Sequence&& s) noexcept
+    : head(std::move(s.head)), tail(std::move(s.tail)), numElts(s.numElts),
+      sortedIndex(std::move(s.sortedIndex)), indexed(s.indexed), touched(std::move(s.touched)),
+      undoLog(std::move(s.undoLog)), txMarks(std::move(s.txMarks)), logGeneration(s.logGeneration),
+      assignOpen(s.assignOpen),
+      posNodes(std::move(s.posNodes)), posStarts(std::move(s.posStarts)), posIndexed(s.posIndexed),
+      walkCost(s.walkCost), maxElts(s.maxElts), spare(std::move(s.spare)), spareCount(s.spareCount),
+      reversed(s.reversed), rotation(s.rotation) {
+    s.tail.reset();                                 // Leave s as a valid empty sequence
+    s.numElts = 0;
+    s.sortedIndex.clear();
+    s.indexed = false;
+    s.touched.clear();
+    s.undoLog.clear();
+    s.txMarks.clear();
+    ++s.logGeneration;                              // s's snapshots went with its log
+    s.assignOpen = false;
+    s.posNodes.clear();
+    s.posStarts.clear();
+    s.posIndexed = false;
+    s.walkCost = 0;
+    s.spareCount = 0;
+    s.reversed = false;
+    s.rotation = 0;
+    SEQUENCE_RECORD_MOVE(s);                        // Recorded once s has been emptied
+}
+
+Sequence& Sequence::operator=(Sequence&& s) {
+    SEQUENCE_RECORD(TraceOp::MoveAssign, this, {SequenceTrace::idOf(&s)});
+    if (this != &s) {                               // Avoid self-assignment
+        clear();                                    // Clear existing nodes (logged as one checkpoint)
+        s.discardLog(0);                            // s's log would point into this chain
+        s.txMarks.clear();
+        s.dropIndex();
+        s.dropPositions();
+        head = std::move(s.head);                   // Take over the chain
+        tail = std::move(s.tail);
+        numElts = s.numElts;
+        limit(s.maxElts);
+        orient(s.reversed, s.rotation);
+        s.tail.reset();
+        s.numElts = 0;
+        s.reversed = false;
+        s.rotation = 0;
     }
     return *this;                                   // Enable assignment chaining
 }
 
+std::shared_ptr<SequenceNode> Sequence::copyChain(std::shared_ptr<SequenceNode>& last) const {
+    std::shared_ptr<SequenceNode> first;
+    last.reset();
+    for (auto node = head.get(); node; node = node->next.get()) {
+        auto copy = std::make_shared<SequenceNode>(node->item);
+        copy->gap = node->gap;
+        if (last) {                                 // Link after the previous copy
+            last->next = copy;
+            copy->prev = last;
+        } else {
+            first = copy;
+        }
+        last = copy;
+    }
+    return first;
+}
+
+void Sequence::releaseChain(std::shared_ptr<SequenceNode> first) {
+    while (first) {                                 // Release nodes one at a time so long
+        auto nextNode = std::move(first->next);     // chains do not destroy recursively
+        first = std::move(nextNode);
+    }
+}
+
 // ============================================================================
 // Element Access
 // ============================================================================
 std::string& Sequence::operator[](size_t position) {
-    return getNode(position)->item;                 // Return reference to element at index
+    SEQUENCE_RECORD(TraceOp::Index, this, {position});
+    auto node = getNode(position);
+    if (indexed)                                    // Caller may rewrite the item through the reference
+        watchIndexed(node.get());
+    if (logging()) {                                // Keep the old value in case of rollback
+        logChange(UndoEntry::Kind::Assign, node);
+        assignOpen = true;                          // Dropped later if the item stays the same
+    }
+    SEQUENCE_TRACK(node->item);                     // Caller may write through the reference
+    return node->item;                              // Return reference to element at index
+}
+
+const std::string& Sequence::at(size_t position) const {
+    SEQUENCE_RECORD(TraceOp::At, this, {position});
+    size_t offset = 0;
+    return findNode(physical(position), offset)->item; // Gaps hold ""
 }
 
 // ============================================================================
 // Modifiers
 // ============================================================================
 void Sequence::push_back(std::string item) {
-    auto newNode = std::make_shared<SequenceNode>(item); // Create new node for item
-
-    if (!head) {                                   // If list is empty
-        head = newNode;                            // New node becomes head
-        tail = newNode;                            // And also the tail
-    } else {
-        auto tailPtr = tail.lock();                // Get strong ref to current tail
-        tailPtr->next = newNode;                   // Link new node after tail
-        newNode->prev = tailPtr;                   // Set back link to old tail
-        tail = newNode;                            // Update tail pointer
-    }
-    ++numElts;                                     // Increment element count
+    SEQUENCE_RECORD(TraceOp::PushBack, this, {}, &item);
+    pushItem(std::move(item), true);
 }
 
 void Sequence::pop_back() {
+    SEQUENCE_RECORD(TraceOp::PopBack, this);
     if (empty())                                   // Prevent pop on empty list
         throw std::runtime_error("Cannot pop_back from empty sequence");
+    dropIndex();                                   // Removed node may still be indexed
+    settle();                                      // Back of the list must be an end of the chain
+    stash(reversed ? removeHead() : removeTail());
+}
+
+void Sequence::push_front(std::string item) {
+    SEQUENCE_RECORD(TraceOp::PushFront, this, {}, &item);
+    pushItem(std::move(item), false);
+}
 
+void Sequence::pop_front() {
+    SEQUENCE_RECORD(TraceOp::PopFront, this);
+    if (empty())                                   // Prevent pop on empty list
+        throw std::runtime_error("Cannot pop_front from empty sequence");
+    dropIndex();                                   // Removed node may still be indexed
+    settle();
+    stash(reversed ? removeTail() : removeHead());
+}
+
+void Sequence::pushItem(std::string item, bool atBack) {
+    dropIndex();                                   // Order is no longer guaranteed
+    settle();                                      // New item goes at an end of the chain
+    bool atTail = atBack != reversed;              // Chain end the item is linked at
+    std::shared_ptr<SequenceNode> newNode;
+    while (maxElts && numElts >= maxElts) {        // Full window: the opposite end makes room
+        stash(std::move(newNode));                 // Only the last evicted node is reused
+        newNode = atTail ? removeHead() : removeTail();
+    }
+    if (newNode)
+        newNode->item = std::move(item);           // Evicted node carries the new item
+    else
+        newNode = takeNode(std::move(item));       // Create new node for item
+    if (atTail || !head)
+        appendNode(newNode);                       // Link it after the tail
+    else
+        linkBefore(head, newNode);                 // New node becomes the head
+    if (logging()) logChange(UndoEntry::Kind::Unlink, newNode);
+    if (!atTail)
+        dropPositions();                           // Every chain slot shifts
+    else if (posIndexed) {                         // Appends keep the positional index
+        posNodes.push_back(newNode);
+        posStarts.push_back(numElts);
+    }
+    ++numElts;                                     // Increment element count
+}
+
+std::shared_ptr<SequenceNode> Sequence::removeHead() {
+    dropPositions();                               // Every position shifts
+    --numElts;
+    if (head->gap > 1) {                           // Leading gap just gets shorter
+        if (logging()) logChange(UndoEntry::Kind::Resize, head, nullptr, head->gap);
+        --head->gap;
+        return nullptr;
+    }
+    auto node = head;
+    if (indexed) unindex(node.get());
+    if (logging()) logChange(UndoEntry::Kind::Relink, node, nullptr);
+    unlink(node);                                  // Remove first node
+    if (logging()) return nullptr;                 // Undo log still refers to it
+    node->gap = 0;
+    return node;
+}
+
+std::shared_ptr<SequenceNode> Sequence::removeTail() {
     auto tailPtr = tail.lock();                    // Get strong reference to tail
+    --numElts;
+    if (tailPtr->gap > 1) {                        // Trailing gap just gets shorter
+        if (logging()) logChange(UndoEntry::Kind::Resize, tailPtr, nullptr, tailPtr->gap);
+        --tailPtr->gap;
+        return nullptr;
+    }
+    if (indexed) unindex(tailPtr.get());
+    if (logging()) logChange(UndoEntry::Kind::Relink, tailPtr, tailPtr->prev.lock());
+    unlink(tailPtr);                               // Remove last node
+    if (posIndexed) {                              // Pops keep the positional index
+        posNodes.pop_back();
+        posStarts.pop_back();
+    }
+    if (logging()) return nullptr;                 // Undo log still refers to it
+    tailPtr->gap = 0;
+    return tailPtr;
+}
 
-    if (head == tailPtr) {                         // If only one element remains
-        head.reset();                              // Remove head
-        tail.reset();                              // Remove tail
-    } else {
-        auto prevNode = tailPtr->prev.lock();      // Get previous node
-        if (prevNode) prevNode->next.reset();      // Detach last node
-        tail = prevNode;                           // Move tail backward
+std::shared_ptr<SequenceNode> Sequence::takeNode(std::string item) {
+    if (!spare)                                    // Nothing to reuse
+        return std::make_shared<SequenceNode>(std::move(item));
+    auto node = std::move(spare);                  // Pop a recycled node
+    spare = std::move(node->next);
+    --spareCount;
+    node->item = std::move(item);
+    return node;
+}
+
+void Sequence::stash(std::shared_ptr<SequenceNode> node) {
+    if (!node || spareCount >= maxElts)            // Unbounded (or enough spares): just free it
+        return;
+    node->next = std::move(spare);                 // Push onto the spare chain
+    spare = std::move(node);
+    ++spareCount;
+}
+
+void Sequence::limit(size_t cap) {
+    if (cap == maxElts) return;
+    if (logging()) logChange(UndoEntry::Kind::Capacity, nullptr, nullptr, maxElts);
+    maxElts = cap;
+}
+
+void Sequence::trimToCapacity() {
+    if (!maxElts || numElts <= maxElts)
+        return;
+    settle();
+    while (numElts > maxElts)                      // Oldest items leave first
+        stash(reversed ? removeTail() : removeHead());
+}
+
+void Sequence::set_capacity(size_t cap) {
+    SEQUENCE_RECORD(TraceOp::SetCapacity, this, {cap});
+    dropIndex();
+    limit(cap);
+    trimToCapacity();
+    while (spareCount > maxElts) {                 // Spare chain never outgrows the window
+        spare = std::move(spare->next);
+        --spareCount;
     }
-    --numElts;                                     // Decrease element count
+}
+
+size_t Sequence::capacity() const {
+    return maxElts;
 }
 
 void Sequence::insert(size_t position, std::string item) {
+    SEQUENCE_RECORD(TraceOp::Insert, this, {position}, &item);
     if (position > numElts)                        // Validate insert index
         throw std::out_of_range("Invalid index for insert");
+    dropIndex();                                   // Order is no longer guaranteed
 
     if (position == numElts) {                     // Append if at end
         push_back(item);
         return;
     }
 
+    settle();                                      // Positions map straight onto chain slots
     auto newNode = std::make_shared<SequenceNode>(item); // Create node to insert
+    size_t slot = reversed ? numElts - position : position; // Chain slot the new node will take
+    if (slot == numElts) {                         // Front of a reversed list is the tail
+        dropPositions();
+        appendNode(newNode);
+        if (logging()) logChange(UndoEntry::Kind::Unlink, newNode);
+        ++numElts;
+        trimToCapacity();
+        return;
+    }
+    size_t offset = 0;
+    auto current = findNode(slot, offset);         // Get node currently covering position
+    dropPositions();                               // Later positions shift
 
-    if (position == 0) {                           // Insert at beginning
-        newNode->next = head;
-        if (head) head->prev = newNode;
-        head = newNode;
-        if (numElts == 0) tail = newNode;          // Update tail if list was empty
+    if (offset > 0) {                              // Landing inside a gap: split it in two
+        if (logging()) logChange(UndoEntry::Kind::Resize, current, nullptr, current->gap);
+        auto rest = makeGap(current->gap - offset);
+        current->gap = offset;
+        linkAfter(current, rest);
+        if (logging()) logChange(UndoEntry::Kind::Unlink, rest);
+        linkAfter(current, newNode);               // New node sits between the two halves
     } else {
-        auto current = getNode(position);          // Get node currently at position
-        auto prevNode = current->prev.lock();      // Get previous node
-
-        newNode->next = current;                   // Link new node before current
-        newNode->prev = prevNode;                  // Link back to previous
-        if (prevNode) prevNode->next = newNode;    // Update previous node’s next
-        current->prev = newNode;                   // Update current node’s prev
+        linkBefore(current, newNode);              // Link new node before current
     }
+    if (logging()) logChange(UndoEntry::Kind::Unlink, newNode);
     ++numElts;                                     // Update count
+    trimToCapacity();                              // A full window drops its oldest item
 }
 
 void Sequence::clear() {
-    head.reset();                                  // Release head chain
+    SEQUENCE_RECORD(TraceOp::Clear, this);
+    dropIndex();                                   // Index points into the released chain
+    dropPositions();
+    if (logging())
+        logRestore(std::move(head), tail.lock(), numElts); // Old chain moves into the log in O(1)
+    else
+        releaseChain(std::move(head));
+    head.reset();
     tail.reset();                                  // Release tail reference
+    releaseChain(std::move(spare));                // Recycled nodes go too
+    spareCount = 0;
     numElts = 0;                                   // Reset count
+    orient(false, 0);
 }
 
 void Sequence::erase(size_t position) {
@@ -131,44 +541,536 @@ void Sequence::erase(size_t position) {
 }
 
 void Sequence::erase(size_t position, size_t count) {
+    SEQUENCE_RECORD(TraceOp::Erase, this, {position, count});
     if (position >= numElts)                       // Validate starting index
         throw std::out_of_range("Invalid erase position");
     if (count == 0)                                // Nothing to remove
         return;
-    if (position + count > numElts)                // Ensure range is valid
+    if (count > numElts - position)                // Ensure range is valid (no overflow)
         throw std::out_of_range("Invalid erase range");
+    dropIndex();                                   // Removed nodes may still be indexed
+    settle();                                      // Range maps onto one run of chain slots
+    if (reversed)
+        position = numElts - position - count;
+
+    size_t offset = 0;
+    auto current = findNode(position, offset);     // First node touched by the range
+    dropPositions();                               // Later positions shift
+    size_t remaining = count;
+
+    while (remaining > 0) {                        // Remove requested slots in one walk
+        auto nextNode = current->next;
+        size_t available = current->span() - offset; // Slots of this node inside the range
+        size_t removed = std::min(available, remaining);
+
+        if (removed == current->span()) {          // Whole node goes away
+            if (logging()) logChange(UndoEntry::Kind::Relink, current, current->prev.lock());
+            unlink(current);
+        } else {                                   // Only part of a gap is removed
+            if (logging()) logChange(UndoEntry::Kind::Resize, current, nullptr, current->gap);
+            current->gap -= removed;
+        }
+
+        remaining -= removed;
+        offset = 0;                                // Later nodes are consumed from their start
+        current = nextNode;
+    }
+    numElts -= count;                              // Decrement size counter
+}
 
-    for (size_t i = 0; i < count; ++i) {           // Remove requested nodes
-        auto toDelete = getNode(position);         // Locate node to remove
-        auto prevNode = toDelete->prev.lock();     // Access previous node
-        auto nextNode = toDelete->next;            // Access next node
+void Sequence::append(Sequence&& other) {
+    SEQUENCE_RECORD(TraceOp::Append, this, {SequenceTrace::idOf(&other)});
+    if (this == &other || other.empty())            // Nothing to splice
+        return;
+    if (other.logging())                            // Its log would point into this chain
+        throw std::runtime_error("Cannot append a sequence with an open transaction");
+    dropIndex();
+    other.dropIndex();
+    straighten();                                   // Both chains must run front to back
+    other.straighten();
+    dropPositions();
+    other.dropPositions();
 
+    auto first = std::move(other.head);             // First node of the spliced run
+    auto tailPtr = tail.lock();
+    if (tailPtr) {                                  // Hook the run after the current tail
+        tailPtr->next = first;
+        first->prev = tailPtr;
+    } else {
+        head = first;
+    }
+    tail = std::move(other.tail);
+    if (logging()) logChange(UndoEntry::Kind::Detach, first, nullptr, other.numElts);
+    numElts += other.numElts;
+    other.tail.reset();
+    other.numElts = 0;
+    trimToCapacity();
+}
+
+// ============================================================================
+// Orientation - reverse() and rotate() are bookkeeping only; see physical()
+// ============================================================================
+size_t Sequence::physical(size_t position) const {
+    if (position >= numElts)                       // Out of range: let findNode report it
+        return position;
+    if (reversed)
+        return (rotation + numElts - 1 - position) % numElts;
+    return (rotation + position) % numElts;
+}
+
+size_t Sequence::logical(size_t slot) const {
+    if (reversed)                                  // The reversed mapping is its own inverse
+        return (rotation + numElts - 1 - slot) % numElts;
+    return (slot + numElts - rotation) % numElts;
+}
+
+void Sequence::reverse() {
+    SEQUENCE_RECORD(TraceOp::Reverse, this);
+    dropIndex();                                   // Ascending order becomes descending
+    orient(!reversed, rotation);                   // Same head offset reads the other way round
+}
+
+void Sequence::rotate(size_t k) {
+    SEQUENCE_RECORD(TraceOp::Rotate, this, {k});
+    if (empty() || k % numElts == 0)
+        return;
+    dropIndex();
+    k %= numElts;
+    orient(reversed, reversed ? (rotation + numElts - k) % numElts : (rotation + k) % numElts);
+}
+
+void Sequence::orient(bool rev, size_t rot) {
+    if (rev != reversed) {
+        if (logging()) logChange(UndoEntry::Kind::Reverse, nullptr);
+        reversed = rev;
+    }
+    if (rot != rotation) {
+        if (logging()) logChange(UndoEntry::Kind::Rotate, nullptr, nullptr, rotation);
+        rotation = rot;
+    }
+}
+
+void Sequence::settle() {
+    if (rotation == 0)                             // Chain already starts at slot 0
+        return;
+    size_t offset = 0;
+    auto seam = findNode(rotation, offset);        // Node that has to become the head
+    if (offset > 0) {                              // Seam inside a gap: split it there
+        if (logging()) logChange(UndoEntry::Kind::Resize, seam, nullptr, seam->gap);
+        auto rest = makeGap(seam->gap - offset);
+        seam->gap = offset;
+        linkAfter(seam, rest);
+        if (logging()) logChange(UndoEntry::Kind::Unlink, rest);
+        seam = rest;
+    }
+    dropPositions();                               // Every chain slot moves
+    if (logging()) logChange(UndoEntry::Kind::Fold, head, nullptr, rotation);
+    spliceToFront(seam);
+    rotation = 0;
+}
+
+void Sequence::straighten() {
+    settle();
+    if (!reversed)
+        return;
+    dropPositions();
+    reverseChain();                                // O(n), only for operations that need the chain in order
+    if (logging()) logChange(UndoEntry::Kind::Flip, nullptr);
+    reversed = false;
+}
+
+void Sequence::spliceToFront(const std::shared_ptr<SequenceNode>& node) {
+    if (node == head)
+        return;
+    auto before = node->prev.lock();               // Last node of the run that moves
+    auto oldTail = tail.lock();
+    auto first = std::move(head);
+    head = std::move(before->next);                // Cut the chain in front of node
+    head->prev.reset();
+    first->prev = oldTail;                         // Hang the old front run after the old tail
+    oldTail->next = std::move(first);
+    tail = before;
+}
+
+void Sequence::reverseChain() {
+    std::shared_ptr<SequenceNode> done;            // Already reversed part, starting at its new head
+    auto current = std::move(head);
+    tail = current;                                // Old head ends up last
+    while (current) {
+        auto nextNode = std::move(current->next);
+        current->prev = nextNode;                  // Old successor now comes first
+        current->next = std::move(done);
+        done = std::move(current);
+        current = std::move(nextNode);
+    }
+    head = std::move(done);
+}
+
+// ============================================================================
+// Ordering - gaps hold "" and therefore sort before every other item
+// ============================================================================
+std::shared_ptr<SequenceNode> Sequence::mergeChains(std::shared_ptr<SequenceNode> a,
+                                                    std::shared_ptr<SequenceNode> b) {
+    SequenceNode dummy;                            // Collects the merged chain
+    SequenceNode* last = &dummy;
+
+    while (a && b) {                               // Take from a on ties to stay stable
+        auto& taken = (b->item < a->item) ? b : a;
+        last->next = std::move(taken);
+        last = last->next.get();
+        taken = std::move(last->next);             // Advance the source chain
+    }
+    last->next = a ? std::move(a) : std::move(b);  // Append whatever is left
+    return std::move(dummy.next);
+}
+
+void Sequence::relinkChain(std::shared_ptr<SequenceNode> first) {
+    head = std::move(first);                       // New chain becomes the list
+    tail.reset();
+
+    std::shared_ptr<SequenceNode> prevNode;
+    auto current = head;
+    while (current) {
+        if (prevNode && prevNode->gap && current->gap) { // Fold neighbouring gaps together
+            prevNode->gap += current->gap;
+            prevNode->next = std::move(current->next);
+            current = prevNode->next;
+            continue;
+        }
+        current->prev = prevNode;                  // Restore back link
+        prevNode = current;
+        current = current->next;
+    }
+    tail = prevNode;                               // Last node visited is the tail
+}
+
+void Sequence::sort() {
+    SEQUENCE_RECORD(TraceOp::Sort, this);
+    dropIndex();
+    dropPositions();
+    if (logging()) logOrder();                     // Nodes are relinked, so remember their order
+    orient(false, 0);                              // Equal items are interchangeable, so the old order only matters to undo
+    std::shared_ptr<SequenceNode> bins[64];        // bins[i] holds a sorted run of 2^i nodes
+    auto current = std::move(head);
+    tail.reset();
+
+    while (current) {                              // Bottom-up merge sort, no recursion
+        auto nextNode = std::move(current->next);
+        auto carry = std::move(current);
+        size_t i = 0;
+        for (; bins[i]; ++i)                       // Older runs go first to keep the sort stable
+            carry = mergeChains(std::move(bins[i]), std::move(carry));
+        bins[i] = std::move(carry);
+        current = std::move(nextNode);
+    }
+
+    std::shared_ptr<SequenceNode> result;
+    for (auto& bin : bins)                         // Higher bins hold earlier nodes
+        if (bin) result = mergeChains(std::move(bin), std::move(result));
+    relinkChain(std::move(result));
+}
+
+void Sequence::merge(Sequence&& other) {
+    SEQUENCE_RECORD(TraceOp::Merge, this, {SequenceTrace::idOf(&other)});
+    if (this == &other)                            // Merging with itself changes nothing
+        return;
+    if (other.logging())                           // Its log would point into this chain
+        throw std::runtime_error("Cannot merge a sequence with an open transaction");
+    dropIndex();
+    other.dropIndex();
+    straighten();                                  // Sorted front to back in the chain as well
+    other.straighten();
+    dropPositions();
+    other.dropPositions();
+    if (logging()) logOrder();                     // Only this sequence can be rolled back
+
+    numElts += other.numElts;                      // Take over all of other's slots
+    other.numElts = 0;
+    other.tail.reset();
+    relinkChain(mergeChains(std::move(head), std::move(other.head)));
+    trimToCapacity();
+}
+
+void Sequence::buildIndex() {
+    sortedIndex.clear();
+    const SequenceNode* prevNode = nullptr;
+    for (auto current = head.get(); current; current = current->next.get()) {
+        if (prevNode && current->item < prevNode->item) { // Gaps compare as ""
+            sortedIndex.clear();
+            throw std::runtime_error("Sequence is not sorted");
+        }
+        if (current->gap == 0)                     // Only real nodes can anchor an insert
+            sortedIndex.insert(sortedIndex.end(), current); // Sorted input: amortized O(1) each
+        prevNode = current;
+    }
+    indexed = true;
+}
+
+void Sequence::dropIndex() {
+    if (!indexed) return;                          // Nothing to invalidate
+    sortedIndex.clear();
+    touched.clear();
+    indexed = false;
+}
+
+void Sequence::watchIndexed(SequenceNode* node) {
+    if (std::find(touched.begin(), touched.end(), node) != touched.end())
+        return;                                    // Already watched
+    if (touched.size() == 64) {                    // Many writes: one rebuild is cheaper
+        dropIndex();
+        return;
+    }
+    auto range = sortedIndex.equal_range(node);    // Key is still the indexed value here
+    for (auto it = range.first; it != range.second; ++it)
+        if (*it == node) {
+            touched.push_back(node);
+            return;
+        }
+    dropIndex();                                   // Slot was a gap until now: not indexed
+}
+
+void Sequence::unindex(const SequenceNode* node) {
+    touched.erase(std::remove(touched.begin(), touched.end(), node), touched.end());
+    if (!sortedIndex.empty() && *sortedIndex.begin() == node)  // Chain ends are index ends
+        sortedIndex.erase(sortedIndex.begin());
+    else if (!sortedIndex.empty() && *std::prev(sortedIndex.end()) == node)
+        sortedIndex.erase(std::prev(sortedIndex.end()));
+    else
+        dropIndex();                               // Not where it should be: start over
+}
+
+void Sequence::recheckTouched() {
+    // The index lists the nodes in chain order, so if the chain is still sorted the
+    // index is too. Only a rewritten node can be out of order with its neighbours.
+    for (SequenceNode* node : touched) {
+        auto prevNode = node->prev.lock();
+        if ((prevNode && node->item < prevNode->item) || (node->next && node->next->item < node->item)) {
+            dropIndex();                           // Rebuilding will report the broken order
+            return;
+        }
+    }
+    touched.clear();
+}
+
+void Sequence::insert_sorted(std::string item) {
+    SEQUENCE_RECORD(TraceOp::InsertSorted, this, {}, &item);
+    if (indexed && !touched.empty())               // Writes through operator[] since the last call
+        recheckTouched();
+    if (!indexed) {                                // First ordered insert since the last change
+        straighten();                              // Index follows the chain
+        buildIndex();
+    }
+    dropPositions();                               // Positions after the new item shift
+
+    auto newNode = std::make_shared<SequenceNode>(std::move(item));
+    auto pos = sortedIndex.upper_bound(newNode->item); // After existing equal items
+    if (pos == sortedIndex.end()) {
+        appendNode(newNode);                       // Largest item goes to the back
+    } else {
+        auto prevNode = (*pos)->prev.lock();       // Node the new item follows, if any
         if (prevNode)
-            prevNode->next = nextNode;             // Skip over deleted node
+            linkAfter(prevNode, newNode);
         else
-            head = nextNode;                       // Update head if first removed
+            linkBefore(head, newNode);             // Smallest item becomes the head
+    }
+    sortedIndex.insert(pos, newNode.get());        // Hint keeps the index update O(1) amortized
+    if (logging()) logChange(UndoEntry::Kind::Unlink, newNode);
+    ++numElts;
+    trimToCapacity();
+}
 
-        if (nextNode)
-            nextNode->prev = prevNode;             // Reconnect backward link
-        else
-            tail = prevNode;                       // Update tail if last removed
+// ============================================================================
+// Transactions - every modifier logs how to reverse itself while a transaction
+// is open; rollback replays the log backwards
+// ============================================================================
+bool Sequence::logging() const {
+    return !txMarks.empty();
+}
+
+void Sequence::logChange(UndoEntry::Kind kind, const std::shared_ptr<SequenceNode>& node,
+                         std::shared_ptr<SequenceNode> after, size_t count) {
+    settleAssign();
+    UndoEntry entry{kind, node, std::move(after), std::string(), count, {}};
+    if (kind == UndoEntry::Kind::Assign)
+        entry.item = node->item;                   // Value before the caller writes
+    undoLog.push_back(std::move(entry));
+}
+
+void Sequence::logRestore(std::shared_ptr<SequenceNode> savedHead, std::shared_ptr<SequenceNode> savedTail,
+                          size_t savedCount) {
+    settleAssign();
+    undoLog.push_back(UndoEntry{UndoEntry::Kind::Restore, std::move(savedHead), std::move(savedTail),
+                                std::string(), savedCount, {}});
+}
+
+void Sequence::settleAssign() {
+    if (!assignOpen)
+        return;
+    assignOpen = false;
+    const UndoEntry& entry = undoLog.back();
+    if (entry.node->item == entry.item)            // Only read: nothing to undo
+        undoLog.pop_back();
+}
+
+void Sequence::logOrder() {
+    settleAssign();
+    UndoEntry entry{UndoEntry::Kind::Reorder, nullptr, nullptr, std::string(), numElts, {}};
+    for (auto node = head; node; node = node->next)
+        entry.order.emplace_back(node, node->gap); // Gaps may be folded together later
+    undoLog.push_back(std::move(entry));
+}
+
+void Sequence::undoTo(size_t mark) {
+    dropIndex();                                   // Order may change while undoing
+    dropPositions();
+    ++logGeneration;                               // Marks past this point will be reused
+    assignOpen = false;                            // Undone like any other entry
+    while (undoLog.size() > mark) {                // Newest change first
+        UndoEntry& entry = undoLog.back();
+        switch (entry.kind) {
+        case UndoEntry::Kind::Assign:
+            entry.node->item = std::move(entry.item);
+            break;
+        case UndoEntry::Kind::Unlink:
+            unlink(entry.node);
+            numElts -= entry.node->span();
+            break;
+        case UndoEntry::Kind::Relink:
+            if (entry.after)
+                linkAfter(entry.after, entry.node); // Back after its old predecessor
+            else if (head)
+                linkBefore(head, entry.node);      // It was the head
+            else
+                appendNode(entry.node);            // It was the only node
+            numElts += entry.node->span();
+            break;
+        case UndoEntry::Kind::Resize:              // Old gap is at least 1 slot
+            numElts += entry.count - entry.node->span();
+            entry.node->gap = entry.count;
+            break;
+        case UndoEntry::Kind::Restore:
+            releaseChain(std::move(head));         // Drop whatever replaced the saved chain
+            head = std::move(entry.node);
+            tail = entry.after;
+            numElts = entry.count;
+            break;
+        case UndoEntry::Kind::Detach: {
+            auto prevNode = entry.node->prev.lock();
+            if (prevNode) prevNode->next.reset(); else head.reset();
+            entry.node->prev.reset();
+            tail = prevNode;
+            numElts -= entry.count;
+            releaseChain(std::move(entry.node));   // Appended run may be long
+            break;
+        }
+        case UndoEntry::Kind::Reorder: {
+            releaseChain(std::move(head));         // Unhooks nodes; the saved ones stay alive
+            std::shared_ptr<SequenceNode> prevNode;
+            for (auto& [node, gap] : entry.order) {
+                node->gap = gap;
+                node->prev = prevNode;
+                if (prevNode) prevNode->next = node; else head = node;
+                prevNode = node;
+            }
+            if (prevNode) prevNode->next.reset();
+            tail = prevNode;
+            numElts = entry.count;
+            break;
+        }
+        case UndoEntry::Kind::Reverse:
+            reversed = !reversed;
+            break;
+        case UndoEntry::Kind::Rotate:
+            rotation = entry.count;
+            break;
+        case UndoEntry::Kind::Fold:
+            spliceToFront(entry.node);
+            rotation = entry.count;
+            break;
+        case UndoEntry::Kind::Flip:
+            reverseChain();
+            reversed = !reversed;
+            break;
+        case UndoEntry::Kind::Capacity:
+            maxElts = entry.count;
+            break;
+        }
+        undoLog.pop_back();
+    }
+}
 
-        --numElts;                                 // Decrement size counter
+void Sequence::discardLog(size_t mark) {
+    ++logGeneration;                               // Snapshots into the dropped entries end here
+    assignOpen = false;
+    while (undoLog.size() > mark) {
+        UndoEntry& entry = undoLog.back();
+        if (entry.kind == UndoEntry::Kind::Restore) // Saved chains may be long; other entries
+            releaseChain(std::move(entry.node));   // point at nodes still in the live chain
+        undoLog.pop_back();
     }
 }
 
+void Sequence::begin_transaction() {
+    SEQUENCE_RECORD(TraceOp::Begin, this);
+    settleAssign();                                // The mark must not move afterwards
+    txMarks.push_back(undoLog.size());             // Remember where this transaction starts
+}
+
+void Sequence::commit() {
+    SEQUENCE_RECORD(TraceOp::Commit, this);
+    if (!logging())
+        throw std::runtime_error("No active transaction");
+    txMarks.pop_back();
+    if (txMarks.empty())                           // Outermost commit: nothing left to undo to
+        discardLog(0);
+}
+
+void Sequence::rollback() {
+    SEQUENCE_RECORD(TraceOp::Rollback, this);
+    if (!logging())
+        throw std::runtime_error("No active transaction");
+    undoTo(txMarks.back());                        // Revert everything since begin_transaction
+    txMarks.pop_back();
+}
+
+Sequence::Snapshot Sequence::snapshot() const {
+    assignOpen = false;                            // Keep the entry: snap.mark counts it
+    Snapshot snap{this, undoLog.size(), logGeneration};
+    SEQUENCE_RECORD_SNAPSHOT(snap);
+    if (!logging())
+        throw std::runtime_error("No active transaction");
+    return snap;
+}
+
+void Sequence::rollback(const Snapshot& snap) {
+    SEQUENCE_RECORD(TraceOp::RollbackTo, this, {SequenceTrace::snapshotOf(this, snap)});
+    if (!logging())
+        throw std::runtime_error("No active transaction");
+    if (snap.owner != this || snap.generation != logGeneration || snap.mark > undoLog.size()
+        || snap.mark < txMarks.back())
+        throw std::out_of_range("Snapshot is not valid in the current transaction");
+    undoTo(snap.mark);
+}
+
+bool Sequence::in_transaction() const {
+    return logging();
+}
+
 // ============================================================================
 // Accessors
 // ============================================================================
 std::string Sequence::front() const {
+    SEQUENCE_RECORD(TraceOp::Front, this);
     if (empty()) throw std::runtime_error("Sequence is empty"); // Check nonempty
-    return head->item;                           // Return first element
+    size_t offset = 0;                           // Either chain end unless rotated
+    return findNode(physical(0), offset)->item;  // Return first element (gaps hold "")
 }
 
 std::string Sequence::back() const {
+    SEQUENCE_RECORD(TraceOp::Back, this);
     if (empty()) throw std::runtime_error("Sequence is empty"); // Check nonempty
-    auto tailPtr = tail.lock();                  // Obtain strong ref to tail
-    return tailPtr->item;                        // Return last element
+    size_t offset = 0;
+    return findNode(physical(numElts - 1), offset)->item; // Return last element (gaps hold "")
 }
 
 bool Sequence::empty() const {
@@ -179,20 +1081,76 @@ size_t Sequence::size() const {
     return numElts;                              // Return number of elements
 }
 
+// ============================================================================
+// Scans - linear walks; a gap contributes each of its slots as ""
+// ============================================================================
+size_t Sequence::find(const std::string& item, size_t from) const {
+    SEQUENCE_RECORD(TraceOp::Find, this, {from}, &item);
+    if (reversed || rotation) {                  // Matches come out of chain order: take the lowest
+        for (size_t position : positionsWhere([&](const std::string& x) { return x == item; }))
+            if (position >= from) return position;
+        return npos;
+    }
+    size_t position = 0;                         // Index of the current node's first slot
+    for (auto current = head.get(); current; current = current->next.get()) {
+        size_t end = position + current->span();
+        if (end > from && current->item == item)  // Match inside the searched range
+            return std::max(position, from);
+        position = end;
+    }
+    return npos;
+}
+
+template <typename Pred>
+std::vector<size_t> Sequence::positionsWhere(Pred&& matches) const {
+    std::vector<size_t> positions;
+    size_t position = 0;
+    for (auto current = head.get(); current; current = current->next.get()) {
+        if (matches(current->item))              // Every slot of a gap matches alike
+            for (size_t i = 0; i < current->span(); ++i)
+                positions.push_back(position + i);
+        position += current->span();
+    }
+    if (reversed || rotation) {                  // Report positions, not chain slots
+        for (auto& p : positions) p = logical(p);
+        std::sort(positions.begin(), positions.end());
+    }
+    return positions;
+}
+
+std::vector<size_t> Sequence::positions_with_length(size_t length) const {
+    SEQUENCE_RECORD(TraceOp::PositionsWithLength, this, {length});
+    return positionsWhere([&](const std::string& item) { return item.size() == length; });
+}
+
+std::vector<size_t> Sequence::positions_with_prefix(const std::string& prefix) const {
+    SEQUENCE_RECORD(TraceOp::PositionsWithPrefix, this, {}, &prefix);
+    return positionsWhere([&](const std::string& item) {
+        return item.size() >= prefix.size() && item.compare(0, prefix.size(), prefix) == 0;
+    });
+}
+
 // Output operator - prints formatted contents of sequence
 
 std::ostream& operator<<(std::ostream& os, const Sequence& s) {
+    SEQUENCE_RECORD(TraceOp::Print, &s);
     os << "<";                                   // Begin list formatting
-    auto current = s.head; // Start at first node
     bool first = true;                           // Track comma placement
 
-    while (current) {                            // Traverse all nodes
-        if (!current->item.empty()) {            // Skip empty strings
-            if (!first) os << ", ";              // Add comma after first element
-            os << current->item;                 // Output current item
-            first = false;                       // Mark first printed
-        }
-        current = current->next;                 // Move to next node
+    if (!s.empty()) {
+        size_t offset = 0;
+        auto start = s.findNode(s.physical(0), offset); // Node holding the first element
+        auto current = start;
+        do {                                     // Traverse all nodes, wrapping at the chain end
+            if (!current->item.empty()) {        // Skip empty strings (and gaps)
+                if (!first) os << ", ";          // Add comma after first element
+                os << current->item;             // Output current item
+                first = false;                   // Mark first printed
+            }
+            current = s.reversed ? current->prev.lock() : current->next; // Move to next node
+            if (!current)
+                current = s.reversed ? s.tail.lock() : s.head;
+        } while (current != start);              // A gap across the seam is visited twice but prints nothing
     }
 
     os << ">";                                   // Close list formatting
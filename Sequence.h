@@ -3,8 +3,10 @@
 
 #include <iostream>
 #include <memory>                   // Provides smart pointers
+#include <set>                      // Provides std::multiset for the ordered-insert index
 #include <string>                   // Provides std::string class
 #include <stdexcept>                // Provides exception classes (runtime_error, out_of_range)
+#include <vector>                   // Provides std::vector for scan results
 // SequenceNode - Node of a doubly-linked list using shared/weak pointers
 
 class SequenceNode {
@@ -12,9 +14,12 @@ public:
     std::string item;                               // Data value stored in this node
     std::shared_ptr<SequenceNode> next;             // Shared pointer to next node
     std::weak_ptr<SequenceNode> prev;               // Weak pointer to previous node
+    size_t gap;                                     // Number of unwritten empty slots this node stands for (0 = real element)
 
-    SequenceNode() : item(""), next(nullptr), prev() {}                  // Default constructor initializes empty node
-    SequenceNode(const std::string& value) : item(value), next(nullptr), prev() {} // Constructor initializes with value
+    SequenceNode() : item(""), next(nullptr), prev(), gap(0) {}                  // Default constructor initializes empty node
+    SequenceNode(std::string value) : item(std::move(value)), next(nullptr), prev(), gap(0) {} // Constructor takes ownership of value
+
+    size_t span() const { return gap ? gap : 1; }   // Number of sequence slots covered by this node
 };
 // Sequence - Doubly linked list supporting random access and dynamic operations
 
@@ -24,25 +29,173 @@ private:
     std::weak_ptr<SequenceNode> tail;               // Pointer to last node
     size_t numElts;                                 // Tracks number of elements in list
 
-    std::shared_ptr<SequenceNode> getNode(size_t position) const; // Returns pointer to node at index
+    // Orders real nodes by item; heterogeneous so the index can be searched with a plain string
+    struct NodeLess {
+        using is_transparent = void;
+        bool operator()(const SequenceNode* a, const SequenceNode* b) const { return a->item < b->item; }
+        bool operator()(const SequenceNode* a, const std::string& b) const { return a->item < b; }
+        bool operator()(const std::string& a, const SequenceNode* b) const { return a < b->item; }
+    };
+    std::multiset<SequenceNode*, NodeLess> sortedIndex; // Search structure used by insert_sorted
+    bool indexed;                                   // True while sortedIndex mirrors the chain
+    // Indexed nodes whose item operator[] handed out for writing. Their keys may have
+    // changed, so the next insert_sorted re-checks just these instead of rebuilding the index.
+    std::vector<SequenceNode*> touched;
+
+    // One reversible change recorded while a transaction is open. Entries refer to
+    // nodes directly, so undoing one never has to walk the chain.
+    struct UndoEntry {
+        enum class Kind {
+            Assign,                                 // Restore node->item to item
+            Unlink,                                 // Remove node that was linked in
+            Relink,                                 // Put removed node back after `after` (null = at head)
+            Resize,                                 // Set gap node back to count slots
+            Restore,                                // Reinstall a saved chain: node = head, after = tail, count = numElts
+            Reorder,                                // Relink the nodes in order (with their gaps), count = numElts
+            Detach,                                 // Cut off node..tail (appended as one run of count slots)
+            Reverse,                                // Toggle the orientation flag back
+            Rotate,                                 // Set the head offset back to count
+            Fold,                                   // Move node (the old head) back to the front, head offset = count
+            Flip,                                   // Reverse the chain back and toggle the orientation flag
+            Capacity                                // Set the capacity back to count
+        } kind;
+        std::shared_ptr<SequenceNode> node;
+        std::shared_ptr<SequenceNode> after;
+        std::string item;
+        size_t count;
+        std::vector<std::pair<std::shared_ptr<SequenceNode>, size_t>> order;
+    };
+    std::vector<UndoEntry> undoLog;                 // Changes made since the outermost begin_transaction
+    std::vector<size_t> txMarks;                    // undoLog size at each open begin_transaction
+    size_t logGeneration;                           // Changes on every undo and outermost commit, ending older snapshots
+    mutable bool assignOpen;                        // undoLog.back() is operator[]'s Assign and is dropped if unused
+
+    // Positional index: once walking to positions has cost more than twice the size
+    // of the list, node pointers are copied into an array so later lookups are O(1)
+    // (O(log n) with gaps). Appends, pops and writes into gaps keep it; other
+    // structural edits drop it and the list goes back to plain walking until reads
+    // dominate again.
+    mutable std::vector<std::shared_ptr<SequenceNode>> posNodes; // Nodes in chain order
+    mutable std::vector<size_t> posStarts;          // First slot of each indexed node
+    mutable bool posIndexed;                        // True while posNodes mirrors the chain
+    mutable size_t walkCost;                        // Nodes stepped over by lookups since the last drop
+
+    // Bounded window: with a capacity set, growth evicts from the opposite end and
+    // evicted nodes are reused for the next item instead of being freed
+    size_t maxElts;                                 // Capacity limit (0 = unbounded)
+    std::shared_ptr<SequenceNode> spare;            // Recycled nodes, chained through next
+    size_t spareCount;                              // Number of nodes on the spare chain
+
+    // Lazy orientation: reverse() and rotate() only change these two fields. Position
+    // p maps to chain slot (rotation + p) % n, or (rotation + n - 1 - p) % n when
+    // reversed. Reads map positions as they go; edits first fold the offset into the
+    // chain (one walk to the seam) and then work on the mapped positions.
+    bool reversed;                                  // True when the chain is read tail to head
+    size_t rotation;                                // Chain slot holding the first element when not reversed
+
+    std::shared_ptr<SequenceNode> findNode(size_t position, size_t& offset) const; // Returns node covering index and offset inside it
+    std::shared_ptr<SequenceNode> getNode(size_t position); // Returns real node at index, materializing a gap if needed
+    void buildPositions() const;                    // Copies the chain into posNodes/posStarts
+    void dropPositions();                           // Returns to plain walking after a structural edit
+    size_t physical(size_t position) const;         // Chain slot holding position under the current orientation
+    size_t logical(size_t slot) const;              // Position of a chain slot under the current orientation
+    void settle();                                  // Folds the head offset into the chain
+    void straighten();                              // Settles and undoes a pending reversal in the chain itself
+    void orient(bool rev, size_t rot);              // Sets the orientation fields (logged)
+    void spliceToFront(const std::shared_ptr<SequenceNode>& node); // Moves the run before node to the end
+    void reverseChain();                            // Reverses the chain in place (prev/next swap roles)
+    void pushItem(std::string item, bool atBack);   // Shared body of push_back and push_front
+    std::shared_ptr<SequenceNode> removeHead();     // Drops the first chain slot; returns its node if reusable
+    std::shared_ptr<SequenceNode> removeTail();     // Drops the last chain slot; returns its node if reusable
+    std::shared_ptr<SequenceNode> takeNode(std::string item); // Reuses a spare node or allocates one
+    void stash(std::shared_ptr<SequenceNode> node); // Keeps a removed node for reuse (bounded mode only)
+    void limit(size_t cap);                         // Sets maxElts (logged)
+    void trimToCapacity();                          // Evicts from the front down to maxElts
+    void appendNode(const std::shared_ptr<SequenceNode>& node); // Links node after current tail
+    void linkAfter(const std::shared_ptr<SequenceNode>& node, const std::shared_ptr<SequenceNode>& newNode); // Links newNode after node
+    void linkBefore(const std::shared_ptr<SequenceNode>& node, const std::shared_ptr<SequenceNode>& newNode); // Links newNode before node
+    void unlink(const std::shared_ptr<SequenceNode>& node); // Detaches node from the chain
+    static std::shared_ptr<SequenceNode> makeGap(size_t count); // Creates a node standing for count empty slots
+    static std::shared_ptr<SequenceNode> mergeChains(std::shared_ptr<SequenceNode> a,
+                                                     std::shared_ptr<SequenceNode> b); // Stable merge of two sorted next-chains
+    void relinkChain(std::shared_ptr<SequenceNode> first); // Installs a next-chain, restoring prev links and tail
+    void buildIndex();                              // Fills sortedIndex (throws if the chain is not sorted)
+    void dropIndex();                               // Invalidates sortedIndex after any other modification
+    void watchIndexed(SequenceNode* node);          // Adds node to touched (drops the index if that is not possible)
+    void unindex(const SequenceNode* node);         // Removes an end node of the chain from the index
+    void recheckTouched();                          // Drops the index if a touched node is now out of order
+    static void releaseChain(std::shared_ptr<SequenceNode> first); // Frees a chain without recursive destruction
+    std::shared_ptr<SequenceNode> copyChain(std::shared_ptr<SequenceNode>& last) const; // Deep copy of the chain; returns head, sets last
+    bool logging() const;                           // True while a transaction is open
+    void logChange(UndoEntry::Kind kind, const std::shared_ptr<SequenceNode>& node,
+                   std::shared_ptr<SequenceNode> after = nullptr, size_t count = 0); // Appends to undoLog
+    void logRestore(std::shared_ptr<SequenceNode> savedHead, std::shared_ptr<SequenceNode> savedTail,
+                    size_t savedCount);             // Logs a whole-chain checkpoint
+    void settleAssign();                            // Drops an open Assign whose item was not rewritten
+    void logOrder();                                // Logs the current node order before nodes are relinked
+    void undoTo(size_t mark);                       // Reverts undoLog entries back to size mark
+    void discardLog(size_t mark);                   // Drops undoLog entries back to size mark without reverting
+    template <typename Pred>
+    std::vector<size_t> positionsWhere(Pred&& matches) const; // Indices of all slots whose item satisfies matches
 
 public:
+    static const size_t npos = static_cast<size_t>(-1); // Returned by find when nothing matches
+
+    // Point inside an open transaction that rollback(Snapshot) can return to. Any
+    // rollback, and the commit of the outermost transaction, ends every snapshot
+    // taken before it.
+    struct Snapshot {
+        const Sequence* owner;                      // Sequence the snapshot was taken from
+        size_t mark;                                // undoLog size when taken
+        size_t generation;                          // owner's logGeneration when taken
+    };
+
     // Constructors / Destructor
-    Sequence(size_t sz = 0);                        // Creates list with given number of empty nodes
+    Sequence(size_t sz = 0);                        // Creates list with sz empty slots, held as a single lazy gap
     Sequence(const Sequence& s);                    // Copy constructor creates deep copy of another Sequence
     ~Sequence();                                    // Destructor releases all resources
     Sequence& operator=(const Sequence& s);         // Assignment operator performs deep copy
+    Sequence(Sequence&& s) noexcept;                // Move constructor takes over the chain
+    Sequence& operator=(Sequence&& s);              // Move assignment takes over the chain (s's open transactions are dropped)
 
     // Element access
     std::string& operator[](size_t position);       // Provides read/write access to element at index
+    const std::string& at(size_t position) const;   // Read-only access to element at index (leaves gaps and logs alone)
 
     // Modifiers
-    void push_back(std::string item);               // Adds new element to end of list
+    void push_back(std::string item);               // Adds new element to end of list (evicts the front when full)
     void pop_back();                                // Removes last element from list
+    void push_front(std::string item);              // Adds new element to front of list (evicts the back when full)
+    void pop_front();                               // Removes first element from list
     void insert(size_t position, std::string item); // Inserts element at given index
     void clear();                                   // Removes all elements from list
     void erase(size_t position);                    // Removes single element at index
     void erase(size_t position, size_t count);      // Removes multiple elements starting at index
+    void append(Sequence&& other);                  // Splices all of other's nodes onto the end in O(1)
+
+    // Bounded window
+    void set_capacity(size_t cap);                  // Limits size to cap, evicting from the front (0 = unbounded)
+    size_t capacity() const;                        // Current limit (0 = unbounded)
+
+    // Orientation
+    void reverse();                                 // Reverses the order in O(1)
+    void rotate(size_t k);                          // Makes element k the front in O(1) (std::rotate order)
+
+    // Ordering
+    void sort();                                    // Stable in-place merge sort of the node chain
+    void merge(Sequence&& other);                   // Merges another sorted sequence into this sorted one in linear time
+    void insert_sorted(std::string item);           // Inserts item at its sorted position in O(log n); items read or written
+                                                    // through operator[] since the last call are re-checked, O(log n) each
+
+    // Transactions - edits are logged as deltas, so rolling back costs O(edits). A
+    // write through operator[]'s reference is rolled back if it is made before
+    // the next operator[] call or modification; reads log nothing.
+    void begin_transaction();                       // Opens a (possibly nested) transaction
+    void commit();                                  // Closes the innermost transaction, keeping its edits
+    void rollback();                                // Undoes and closes the innermost transaction
+    Snapshot snapshot() const;                      // Cheap handle to the current state inside a transaction
+    void rollback(const Snapshot& snap);            // Undoes edits made since snap; transaction stays open
+    bool in_transaction() const;                    // True while any transaction is open
 
     // Accessors
     std::string front() const;                      // Returns first element (throws if empty)
@@ -50,6 +203,11 @@ public:
     bool empty() const;                             // Checks if list contains no elements
     size_t size() const;                            // Returns current number of elements
 
+    // Scans (same interface as GapSequence)
+    size_t find(const std::string& item, size_t from = 0) const;              // Index of first equal item at or after from
+    std::vector<size_t> positions_with_length(size_t length) const;           // Indices of items with the given length
+    std::vector<size_t> positions_with_prefix(const std::string& prefix) const; // Indices of items starting with prefix
+
     // Output
     friend std::ostream& operator<<(std::ostream& os, const Sequence& s); // Prints formatted list to output stream
 };
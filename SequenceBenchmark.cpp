@@ -0,0 +1,402 @@
+#include <chrono>          // For wall-clock timing
+#include <cstdlib>         // For malloc/free in the counting allocator
+#include <filesystem>      // For the temporary ingestion input
+#include <fstream>         // For file streams
+#include <new>             // For std::bad_alloc
+#include <iomanip>         // For table formatting
+#include <iostream>        // For console I/O
+#include <random>          // For reproducible workloads
+#include <string>          // For string handling
+#include <vector>          // For pre-generated inputs
+#include "Sequence.h"      // Includes the Sequence class definition
+#include "GapSequence.h"   // Includes the contiguous backend
+#include "SequenceIngest.h" // Includes the streaming loader
+
+using namespace std;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+using Clock = chrono::steady_clock;
+volatile size_t benchSink = 0;                     // Keeps measured results observable
+size_t allocatedBytes = 0;                         // Bytes requested through operator new
+size_t allocationCount = 0;                        // Calls to operator new
+
+// Counting global allocator so benchmarks can report memory and allocation traffic
+void* operator new(size_t size) {
+    allocatedBytes += size;
+    ++allocationCount;
+    if (void* p = malloc(size)) return p;
+    throw bad_alloc();
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+// Runs fn once and returns the elapsed time in milliseconds
+template <typename Fn>
+double timeMs(Fn&& fn) {
+    auto start = Clock::now();
+    fn();
+    return chrono::duration<double, milli>(Clock::now() - start).count();
+}
+
+// Produces n pseudo-random fixed-width keys so string order matches numeric order
+vector<string> randomKeys(size_t n, unsigned seed) {
+    mt19937 rng(seed);
+    uniform_int_distribution<unsigned> dist(0, 99999999);
+    vector<string> keys;
+    keys.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        string key = to_string(dist(rng));
+        keys.push_back(string(8 - key.size(), '0') + key);
+    }
+    return keys;
+}
+
+void printRow(const string& name, size_t n, double ms) {
+    cout << "  " << left << setw(42) << name << right << setw(9) << n
+         << setw(12) << fixed << setprecision(2) << ms << " ms" << endl;
+}
+
+// ============================================================================
+// BENCHMARK: Sorted maintenance
+// PURPOSE: Compares keeping a Sequence sorted by scanning with operator[] and
+//          calling insert against insert_sorted, sort() and merge()
+// ============================================================================
+void benchSorted() {
+    cout << "Sorted maintenance" << endl;
+    for (size_t n : {250u, 500u, 1000u}) {
+        auto keys = randomKeys(n, 1);
+        double ms = timeMs([&] {
+            Sequence s;
+            for (const auto& key : keys) {           // Hand-written ordered insert
+                size_t i = 0;
+                while (i < s.size() && s[i] < key) ++i;
+                s.insert(i, key);
+            }
+        });
+        printRow("scan + insert", n, ms);
+    }
+    for (size_t n : {1000u, 100000u, 1000000u}) {
+        auto keys = randomKeys(n, 1);
+        printRow("insert_sorted", n, timeMs([&] {
+            Sequence s;
+            for (const auto& key : keys) s.insert_sorted(key);
+        }));
+
+        Sequence unsorted;
+        for (const auto& key : keys) unsorted.push_back(key);
+        printRow("sort() of random input", n, timeMs([&] { unsorted.sort(); }));
+
+        Sequence b;
+        auto more = randomKeys(n, 2);
+        for (const auto& key : more) b.push_back(key);
+        b.sort();
+        printRow("merge() of two sorted halves", 2 * n, timeMs([&] { unsorted.merge(std::move(b)); }));
+    }
+    cout << endl;
+}
+
+// ============================================================================
+// BENCHMARK: Backends
+// PURPOSE: Runs read-mostly and edit-point workloads against the linked
+//          Sequence and the contiguous GapSequence through the same API
+// ============================================================================
+template <typename Seq>
+void benchBackend(const string& name, size_t n) {
+    auto keys = randomKeys(n, 3);
+    Seq s;
+    for (const auto& key : keys) s.push_back(key);
+
+    mt19937 rng(4);
+    uniform_int_distribution<size_t> pick(0, n - 1);
+    size_t reads = n < 10000 ? 10000 : 2000, found = 0;
+    printRow(name + " random at()", reads, timeMs([&] {
+        for (size_t i = 0; i < reads; ++i) found += s.at(pick(rng)).size();
+    }));
+    printRow(name + " find() x100", n, timeMs([&] {
+        for (size_t i = 0; i < 100; ++i) found += s.find(keys[pick(rng)]);
+    }));
+    printRow(name + " positions_with_prefix() x100", n, timeMs([&] {
+        for (size_t i = 0; i < 100; ++i) found += s.positions_with_prefix(keys[i].substr(0, 3)).size();
+    }));
+    printRow(name + " insert at moving cursor", 10000, timeMs([&] {
+        size_t cursor = n / 2;
+        for (size_t i = 0; i < 10000; ++i) {    // Typing: insert, occasionally step
+            s.insert(cursor, keys[i % n]);
+            cursor += (i % 16 == 0) ? 1 : 0;
+        }
+    }));
+    benchSink = found;
+}
+
+void benchBackends() {
+    cout << "Backends" << endl;
+    for (size_t n : {1000u, 100000u}) {
+        benchBackend<Sequence>("linked", n);
+        benchBackend<GapSequence>("gap buffer", n);
+    }
+    cout << endl;
+}
+
+// ============================================================================
+// BENCHMARK: Undo
+// PURPOSE: Compares checkpointing with the copy constructor and restoring by
+//          assignment against begin_transaction()/rollback() for a few edits
+// ============================================================================
+void applyEdits(Sequence& s, size_t edits, unsigned seed) {
+    mt19937 rng(seed);
+    for (size_t i = 0; i < edits; ++i) {
+        uniform_int_distribution<size_t> pick(0, s.size() - 1);
+        switch (i % 3) {
+        case 0: s[pick(rng)] = "edited"; break;
+        case 1: s.insert(pick(rng), "inserted"); break;
+        case 2: s.erase(pick(rng)); break;
+        }
+    }
+}
+
+void printUndoRow(const string& name, size_t edits, double ms, size_t bytes) {
+    cout << "  " << left << setw(26) << name << right << setw(7) << edits << " edits"
+         << setw(12) << fixed << setprecision(2) << ms << " ms" << setw(12) << bytes / 1024 << " KiB allocated" << endl;
+}
+
+void benchUndo() {
+    cout << "Undo (sequence of 100000)" << endl;
+    Sequence s;
+    for (const auto& key : randomKeys(100000, 5)) s.push_back(key);
+
+    for (size_t edits : {10u, 100u, 1000u}) {
+        size_t bytesBefore = allocatedBytes;
+        double ms = timeMs([&] {
+            Sequence checkpoint(s);               // Full-copy checkpoint
+            applyEdits(s, edits, 6);
+            s = checkpoint;                       // Roll back by copying it back
+        });
+        printUndoRow("copy checkpoint", edits, ms, allocatedBytes - bytesBefore);
+
+        bytesBefore = allocatedBytes;
+        ms = timeMs([&] {
+            s.begin_transaction();
+            applyEdits(s, edits, 6);
+            s.rollback();                         // Replays the logged deltas
+        });
+        printUndoRow("transaction rollback", edits, ms, allocatedBytes - bytesBefore);
+    }
+    cout << endl;
+}
+
+// ============================================================================
+// BENCHMARK: Ingestion
+// PURPOSE: Compares loading a file with getline + push_back against the
+//          coroutine ingestion pipeline, reported in MB/s
+// ============================================================================
+void benchIngest() {
+    cout << "Ingestion" << endl;
+    auto path = filesystem::temp_directory_path() / "sequence_ingest_bench.txt";
+    {
+        ofstream out(path, ios::binary);          // About 40 MB of short records
+        auto keys = randomKeys(1000000, 7);
+        for (size_t i = 0; i < keys.size(); ++i)
+            out << keys[i] << " record " << i << " payload " << keys[(i * 7) % keys.size()] << '\n';
+    }
+    double megabytes = filesystem::file_size(path) / (1024.0 * 1024.0);
+
+    auto report = [&](const string& name, double ms, size_t records) {
+        cout << "  " << left << setw(26) << name << right << setw(9) << records << " records"
+             << setw(10) << fixed << setprecision(1) << megabytes / (ms / 1000.0) << " MB/s" << endl;
+    };
+
+    double naiveMs = 1e300, streamedMs = 1e300;    // Best of three rounds each
+    size_t naiveRecords = 0, streamedRecords = 0;
+    for (int round = 0; round < 3; ++round) {     // Pipeline first, so both loops run after the
+        {                                          // reader thread exists (malloc then takes locks)
+            Sequence streamed;
+            streamedMs = min(streamedMs, timeMs([&] {
+                ifstream in(path, ios::binary);
+                streamedRecords = ingest(streamed, in);
+            }));
+        }
+        {
+            Sequence naive;
+            naiveMs = min(naiveMs, timeMs([&] {
+                ifstream in(path, ios::binary);
+                for (string line; getline(in, line);) naive.push_back(line);
+            }));
+            naiveRecords = naive.size();
+        }
+    }
+    report("getline + push_back", naiveMs, naiveRecords);
+    report("coroutine ingest", streamedMs, streamedRecords);
+    filesystem::remove(path);
+    cout << endl;
+}
+
+// ============================================================================
+// BENCHMARK: Phase changes
+// PURPOSE: Runs a workload whose operation mix changes phase by phase.
+//          Compare with SequenceBenchmarkLinkedOnly, where Sequence never
+//          switches to its positional index.
+// ============================================================================
+template <typename Seq>
+void benchPhases(const string& name) {
+    const size_t n = 100000;
+    auto keys = randomKeys(n, 8);
+    mt19937 rng(9);
+    size_t found = 0;
+    Seq s;
+    double total = 0;
+    auto phase = [&](const string& label, auto&& fn) {
+        double ms = timeMs(fn);
+        total += ms;
+        printRow(name + " " + label, s.size(), ms);
+    };
+
+    phase("append", [&] { for (const auto& key : keys) s.push_back(key); });
+    phase("random reads x5000", [&] {
+        for (size_t i = 0; i < 5000; ++i) found += s.at(rng() % s.size()).size();
+    });
+    phase("middle edits x200", [&] {
+        for (size_t i = 0; i < 100; ++i) {
+            s.insert(rng() % s.size(), keys[i]);
+            s.erase(rng() % s.size());
+        }
+    });
+    phase("random reads x5000", [&] {
+        for (size_t i = 0; i < 5000; ++i) found += s.at(rng() % s.size()).size();
+    });
+    phase("queue push/erase(0) x2000", [&] {
+        for (size_t i = 0; i < 2000; ++i) {   // The gap buffer shifts everything here
+            s.push_back(keys[i]);
+            s.erase(0);
+        }
+    });
+    phase("sequential at() scan x20000", [&] {
+        for (size_t i = 0; i < 20000; ++i) found += s.at(i).size();
+    });
+    const size_t fill = 20000;
+    double fillMs = timeMs([&] {                  // Presized, then written slot by slot
+        Seq presized(fill);
+        for (size_t i = 0; i < fill; ++i) presized[i] = keys[i];
+        found += presized.size();
+    });
+    total += fillMs;
+    printRow(name + " presized operator[] fill x20000", fill, fillMs);
+    printRow(name + " total", s.size(), total);
+    benchSink = found;
+}
+
+void benchPhaseChanges() {
+#ifdef SEQUENCE_LINKED_ONLY
+    cout << "Phase changes (linked only)" << endl;
+#else
+    cout << "Phase changes" << endl;
+#endif
+    benchPhases<Sequence>("linked");
+    benchPhases<GapSequence>("gap buffer");
+    cout << endl;
+}
+
+// ============================================================================
+// BENCHMARK: Sliding window
+// PURPOSE: Measures sustained events/sec when a full window takes one new event
+//          and drops its oldest, comparing the bounded mode against an
+//          unbounded sequence doing push_back + pop_front
+// ============================================================================
+void printWindowRow(const string& name, size_t window, size_t events, double ms, size_t allocs) {
+    cout << "  " << left << setw(26) << name << right << setw(9) << window
+         << setw(12) << fixed << setprecision(2) << events / ms / 1000.0 << " M events/s"
+         << setw(10) << allocs << " allocations" << endl;
+}
+
+void benchWindow() {
+    cout << "Sliding window (2000000 events)" << endl;
+    const size_t events = 2000000;
+    auto keys = randomKeys(1 << 16, 11);          // Short keys stay in the string's inline buffer
+    for (size_t window = 100; window <= 1000000; window *= 10) {
+        Sequence bounded;
+        bounded.set_capacity(window);
+        Sequence unbounded;
+        for (size_t i = 0; i < window; ++i) {
+            bounded.push_back(keys[i & 0xFFFF]);
+            unbounded.push_back(keys[i & 0xFFFF]);
+        }
+
+        size_t allocsBefore = allocationCount;
+        double ms = timeMs([&] {
+            for (size_t i = 0; i < events; ++i)
+                bounded.push_back(keys[i & 0xFFFF]); // Evicts and reuses the oldest node
+        });
+        printWindowRow("bounded push_back", window, events, ms, allocationCount - allocsBefore);
+
+        allocsBefore = allocationCount;
+        ms = timeMs([&] {
+            for (size_t i = 0; i < events; ++i) {
+                unbounded.push_back(keys[i & 0xFFFF]);
+                unbounded.pop_front();
+            }
+        });
+        printWindowRow("push_back + pop_front", window, events, ms, allocationCount - allocsBefore);
+        benchSink = benchSink + bounded.size() + unbounded.size();
+    }
+    cout << endl;
+}
+
+// ============================================================================
+// BENCHMARK: Reverse and rotate
+// PURPOSE: Compares rebuilding a reversed or rotated sequence element by element
+//          against the lazy reverse()/rotate(), including the first push_back
+//          that folds the rotation into the chain
+// ============================================================================
+void benchOrientation() {
+    for (size_t n : {10000u, 100000u, 1000000u}) {
+        cout << "Reverse and rotate (sequence of " << n << ")" << endl;
+        Sequence s;
+        for (const auto& key : randomKeys(n, 13)) s.push_back(key);
+
+        double ms = timeMs([&] {
+            Sequence rebuilt;
+            while (!s.empty()) {                  // Old way: move items over one by one
+                rebuilt.push_back(s.back());
+                s.pop_back();
+            }
+            s = std::move(rebuilt);
+        });
+        printRow("reverse by rebuilding", n, ms);
+        ms = timeMs([&] { s.reverse(); });
+        printRow("reverse()", n, ms);
+
+        size_t k = n / 3;
+        ms = timeMs([&] {
+            for (size_t i = 0; i < k; ++i) {      // Old way: cycle the front to the back
+                s.push_back(s.front());
+                s.erase(0);
+            }
+        });
+        printRow("rotate by erase + push_back", n, ms);
+        ms = timeMs([&] { s.rotate(k); });
+        printRow("rotate()", n, ms);
+        ms = timeMs([&] { s.push_back("x"); });
+        printRow("first push_back after rotate()", n, ms);
+        benchSink = benchSink + s.size();
+        cout << endl;
+    }
+}
+
+// ============================================================================
+// MAIN FUNCTION
+// PURPOSE: Runs every benchmark and prints one table per workload.
+// ============================================================================
+int main() {
+    cout << "SEQUENCE BENCHMARKS" << endl << endl;
+
+    benchSorted();
+    benchBackends();
+    benchUndo();
+    benchIngest();
+    benchPhaseChanges();
+    benchWindow();
+    benchOrientation();
+
+    return 0;
+}
@@ -2,7 +2,13 @@
 #include <string>          // For string handling
 #include <cassert>         // For runtime test validation
 #include <stdexcept>       // For exception handling
+#include <algorithm>       // For reference reverse/rotate/sort
+#include <sstream>         // For capturing printed sequences
+#include <vector>          // For scan results
 #include "Sequence.h"      // Includes the Sequence class definition
+#include "GapSequence.h"   // Includes the contiguous backend
+#include "SequenceIngest.h" // Includes the streaming loader
+#include "SequenceTrace.h" // Includes the trace recorder and replayer
 
 using namespace std;
 
@@ -316,6 +322,599 @@ void testOutputFormat() {
     cout << "PASS" << endl << endl;
 }
 
+// ============================================================================
+// TEST 22: Lazy sized construction
+// PURPOSE: Verifies that unwritten slots of a presized sequence behave like
+//          empty strings through writes, inserts, erases and pops
+// ============================================================================
+void testLazySized() {
+    cout << "TEST 22: Lazy sized construction" << endl;
+    Sequence s(1000000);                          // Large presized sequence (no nodes built)
+    assert(s.size() == 1000000 && s.front() == "" && s.back() == "");
+    s[500000] = "mid";                            // Write in the middle of the gap
+    s[0] = "first";                               // Write the first slot
+    s[999999] = "last";                           // Write the last slot
+    assert(s[500000] == "mid" && s[499999] == "" && s[500001] == "");
+    s.insert(250000, "ins");                      // Insert inside the leading gap
+    assert(s.size() == 1000001 && s[250000] == "ins" && s[500001] == "mid");
+    s.erase(1, 249999);                           // Erase the empty run before "ins"
+    assert(s.size() == 750002 && s[1] == "ins" && s[250002] == "mid");
+    s.erase(2, 250001);                           // Erase gap slots and "mid" in one call
+    assert(s[2] == "" && s.back() == "last");
+    s.pop_back(); s.pop_back();                   // Pop "last" then one gap slot
+    assert(s.size() == 499999 && s.back() == "");
+    cout << "Sparse sequence: " << s << endl;     // Gaps print nothing, like empty strings
+    Sequence copy(s);                             // Copy keeps gaps and values
+    assert(copy.size() == s.size() && copy[1] == "ins");
+    cout << "PASS" << endl << endl;
+}
+
+// ============================================================================
+// TEST 23: sort() and merge()
+// PURPOSE: Verifies stable in-place sorting (gaps sort first as empty strings)
+//          and linear merging of two sorted sequences
+// ============================================================================
+void testSortAndMerge() {
+    cout << "TEST 23: sort() and merge()" << endl;
+    Sequence s(3);                                // Three unwritten slots
+    s.push_back("pear"); s.push_back("apple"); s.push_back("fig");
+    s[1] = "kiwi";
+    s.sort();
+    cout << "Sorted: " << s << endl;
+    assert(s.size() == 6 && s[0] == "" && s[1] == "" && s[2] == "apple" && s[5] == "pear");
+    assert(s.front() == "" && s.back() == "pear");
+
+    Sequence other;
+    other.push_back("banana"); other.push_back("grape"); other.push_back("zucchini");
+    s.merge(std::move(other));
+    cout << "Merged: " << s << endl;
+    assert(s.size() == 9 && other.empty());
+    assert(s[3] == "banana" && s[5] == "grape" && s.back() == "zucchini");
+    s.pop_back(); s.erase(0);                     // Chain links stay consistent after merge
+    assert(s.size() == 7 && s.back() == "pear" && s[1] == "apple");
+    cout << "PASS" << endl << endl;
+}
+
+// ============================================================================
+// TEST 24: insert_sorted()
+// PURPOSE: Verifies ordered inserts keep the sequence sorted, stay stable for
+//          equal items, and reject an unsorted sequence
+// ============================================================================
+void testInsertSorted() {
+    cout << "TEST 24: insert_sorted()" << endl;
+    Sequence s;
+    const char* words[] = {"m", "c", "x", "a", "m", "z", "b"};
+    for (const char* w : words) s.insert_sorted(w);
+    cout << "Ordered inserts: " << s << endl;
+    assert(s.size() == 7 && s.front() == "a" && s.back() == "z" && s[3] == "m" && s[4] == "m");
+    s.push_back("zz");                            // Plain modification drops the index
+    s.insert_sorted("n");                         // Index is rebuilt from the chain
+    assert(s[5] == "n" && s.back() == "zz");
+
+    for (size_t i = 0; i < s.size(); i++)         // Reads keep the index
+        assert(!s[i].empty());
+    s[1] = "ba";                                  // An in-order write keeps it too
+    s.insert_sorted("bb");
+    assert(s[1] == "ba" && s[2] == "bb" && s[3] == "c");
+    s[1] = "b";
+    s.insert_sorted("aa");
+    assert(s[0] == "a" && s[1] == "aa" && s[2] == "b" && s[3] == "bb");
+
+    s[0] = "q";                                   // Break the order through operator[]
+    try {
+        s.insert_sorted("k");                     // Should throw: sequence not sorted
+        assert(false);
+    } catch (const std::exception& e) {
+        cout << "Correctly caught exception: " << e.what() << endl;
+    }
+    cout << "PASS" << endl << endl;
+}
+
+// ============================================================================
+// TEST 25: GapSequence backend
+// PURPOSE: Runs the same edits and scans on both backends and checks that the
+//          contiguous gap buffer matches the linked list exactly
+// ============================================================================
+template <typename Seq>
+string runBackendScript() {
+    ostringstream out;
+    Seq s(4);
+    s[1] = "alpha";
+    s.push_back("beta"); s.push_back("alphabet"); s.push_back("gamma");
+    s.insert(0, "delta"); s.insert(3, "alpha");   // Gap moves back and forth
+    s.erase(5, 2);
+    s.pop_back();
+    for (int i = 0; i < 40; i++) s.push_back("item" + to_string(i % 7));
+    s[10] = "alpha";                              // Written through the reference
+    s.erase(20, 10);
+    out << s << " size=" << s.size() << " front=" << s.front() << " back=" << s.back();
+    out << " find(alpha)=" << s.find("alpha") << "," << s.find("alpha", 3) << "," << s.find("alpha", 4);
+    out << " find(none)=" << (s.find("none") == Seq::npos);
+    for (size_t p : s.positions_with_prefix("alpha")) out << " p" << p;
+    for (size_t p : s.positions_with_prefix("item3")) out << " q" << p;
+    for (size_t p : s.positions_with_length(0)) out << " e" << p;
+    try { s.erase(1, static_cast<size_t>(-1)); } catch (const std::out_of_range&) { out << " hugeErase=rejected"; }
+    out << " size=" << s.size();                  // Rejected erase leaves everything in place
+    Seq copy(s);
+    copy[0] = "changed";
+    out << " copyfind=" << copy.find("changed") << " origfind=" << (s.find("changed") == Seq::npos);
+    string& held = s[1];
+    s.find("zz");                                 // A scan between handing out and writing
+    held = "hello";
+    out << " heldfind=" << s.find("hello") << "," << s.positions_with_length(5).size();
+    size_t filled = 0;
+    for (size_t i = 0; i < 3 * s.size(); i++)     // Read-only access marks nothing for the scans
+        filled += !s.at(i % s.size()).empty();
+    out << " filled=" << filled << " at=" << s.at(0) << "," << s.at(1) << "," << s.at(s.size() - 1) << " find=" << s.find("item6");
+    try { s.at(s.size()); } catch (const std::out_of_range&) { out << " atEnd=rejected"; }
+    return out.str();
+}
+
+void testGapSequence() {
+    cout << "TEST 25: GapSequence backend" << endl;
+    string linked = runBackendScript<Sequence>();
+    string contiguous = runBackendScript<GapSequence>();
+    cout << "Linked:     " << linked << endl;
+    cout << "Contiguous: " << contiguous << endl;
+    assert(linked == contiguous);                 // Same API, same results
+    cout << "PASS" << endl << endl;
+}
+
+// ============================================================================
+// TEST 26: Transactions
+// PURPOSE: Verifies rollback restores every kind of modification, snapshots
+//          roll back partially, nested commits fold into the outer transaction
+// ============================================================================
+string show(const Sequence& s) {
+    ostringstream out;
+    out << s << "/" << s.size();                  // Size catches differences in empty slots
+    return out.str();
+}
+
+void testTransactions() {
+    cout << "TEST 26: Transactions" << endl;
+    Sequence s(5);
+    s[1] = "B"; s[3] = "D";
+    s.push_back("F");
+    string before = show(s);
+
+    s.begin_transaction();
+    s[0] = "A"; s[1] = "b";                       // Writes into a gap and over a value
+    s.push_back("G"); s.insert(2, "X"); s.insert(5, "Y");
+    s.pop_back(); s.pop_back();
+    s.erase(1, 4);                                // Mixes real nodes and gap slots
+    Sequence::Snapshot mid = s.snapshot();
+    string atMid = show(s);
+    s.sort(); s.insert_sorted("C");
+    s.clear(); s.push_back("only");
+    s.rollback(mid);                              // Partial rollback, transaction stays open
+    assert(show(s) == atMid && s.in_transaction());
+    s.rollback();
+    cout << "After rollback: " << s << endl;
+    assert(show(s) == before && !s.in_transaction());
+    assert(s[1] == "B" && s[3] == "D" && s.back() == "F");
+
+    s.begin_transaction();
+    s.push_back("H");
+    s.begin_transaction();                        // Nested transaction
+    s.erase(0);
+    s.commit();                                   // Inner edits join the outer transaction
+    Sequence other; other = s;                    // Assignment while logging
+    s = Sequence(2);
+    s.rollback();
+    assert(show(s) == before);
+    s.begin_transaction();
+    s[2] = "Z"; s.erase(0); s.clear(); s.push_back("Y");
+    s.commit();                                   // Committed edits stay
+    assert(show(s) == "<Y>/1" && s.back() == "Y");
+    s.begin_transaction();
+    s.push_back("W"); s[0] = "V";
+    s.commit();                                   // Committing leaves the chain intact
+    assert(show(s) == "<V, W>/2" && s.back() == "W");
+
+    Sequence t;                                   // Stale snapshots are refused
+    t.begin_transaction();
+    Sequence::Snapshot s0 = t.snapshot();
+    t.push_back("A");
+    Sequence::Snapshot s1 = t.snapshot();
+    t.rollback(s0);
+    t.push_back("B"); t.push_back("C");
+    bool refused = false;
+    try { t.rollback(s1); } catch (const std::out_of_range&) { refused = true; }
+    assert(refused && show(t) == "<B, C>/2");
+    t.commit();
+    t.begin_transaction();
+    Sequence::Snapshot committed = t.snapshot();
+    t.commit();                                   // Outermost commit ends the snapshot
+    t.begin_transaction();
+    t.push_back("x"); t.push_back("y");
+    refused = false;
+    try { t.rollback(committed); } catch (const std::out_of_range&) { refused = true; }
+    assert(refused && show(t) == "<B, C, x, y>/4");
+    t.rollback();
+
+    t.begin_transaction();                        // Reads log nothing, writes are still undone
+    for (size_t i = 0; i < t.size(); i++) assert(!t[i].empty());
+    t[1] = "c";
+    (void)t[0];
+    t.push_back("D");
+    assert(t.snapshot().mark == 2);               // The write to t[1] and the push
+    t.rollback();
+    assert(show(t) == "<B, C>/2");
+
+    try {
+        s.commit();                               // No transaction open
+        assert(false);
+    } catch (const std::exception& e) {
+        cout << "Correctly caught exception: " << e.what() << endl;
+    }
+    cout << "PASS" << endl << endl;
+}
+
+// ============================================================================
+// TEST 27: Streaming ingestion
+// PURPOSE: Verifies the coroutine pipeline produces the same records as a
+//          getline + push_back loop, including records split across chunks,
+//          empty lines and a final line without a newline
+// ============================================================================
+void testIngest() {
+    cout << "TEST 27: Streaming ingestion" << endl;
+    string text = "alpha\nbeta\n\ngamma delta\nepsilon-zeta-eta\n\ntheta";
+    Sequence expected;
+    istringstream lines(text);
+    for (string line; getline(lines, line);) expected.push_back(line);
+
+    for (size_t chunkSize : {1u, 4u, 7u, 1024u}) { // Tiny chunks force records across borders
+        Sequence loaded(2);                       // Records are appended after existing slots
+        loaded[0] = "existing";
+        istringstream in(text);
+        size_t records = ingest(loaded, in, chunkSize, 3);
+        assert(records == expected.size() && loaded.size() == expected.size() + 2);
+        for (size_t i = 0; i < expected.size(); i++) assert(loaded[i + 2] == expected[i]);
+    }
+
+    Sequence target;
+    target.push_back("kept");
+    target.begin_transaction();
+    istringstream in(text);
+    ingest(target, in);
+    cout << "Ingested: " << target << endl;
+    target.rollback();                            // Appended batches are undone as a whole
+    assert(target.size() == 1 && target.back() == "kept");
+    cout << "PASS" << endl << endl;
+}
+
+// ============================================================================
+// TEST 28: Phase-changing workload
+// PURPOSE: Alternates read-heavy, append, middle-edit and queue phases so the
+//          sequence switches to and from its positional index, checking every
+//          result against a vector
+// ============================================================================
+void testPhaseChanges() {
+    cout << "TEST 28: Phase-changing workload" << endl;
+    Sequence s(50);                               // Starts with a gap
+    vector<string> ref(50);
+    for (int i = 0; i < 500; i++) { s.push_back(to_string(i)); ref.push_back(to_string(i)); }
+
+    for (int round = 0; round < 4; round++) {
+        for (size_t i = 0; i < 3000; i++) {      // Read-heavy phase builds the index
+            size_t p = (i * 7919 + round) % ref.size();
+            assert(s[p] == ref[p]);
+        }
+        for (int i = 0; i < 20; i++) {            // Appends and pops keep it
+            s.push_back("a" + to_string(i)); ref.push_back("a" + to_string(i));
+            if (i % 3 == 0) { s.pop_back(); ref.pop_back(); }
+        }
+        for (size_t i = 0; i < ref.size(); i++) assert(s[i] == ref[i]);
+        for (int i = 0; i < 10; i++) {            // Middle edits drop it
+            size_t p = (i * 37 + round) % ref.size();
+            s.insert(p, "m"); ref.insert(ref.begin() + p, "m");
+            s.erase(p / 2, 2); ref.erase(ref.begin() + p / 2, ref.begin() + p / 2 + 2);
+        }
+        for (int i = 0; i < 30; i++) {            // Queue phase
+            s.push_back("q"); ref.push_back("q");
+            s.erase(0); ref.erase(ref.begin());
+        }
+        assert(s.size() == ref.size() && s.front() == ref.front() && s.back() == ref.back());
+    }
+    for (size_t i = 0; i < ref.size(); i++) assert(s[i] == ref[i]);
+    cout << "Final size: " << s.size() << endl;
+    cout << "PASS" << endl << endl;
+}
+
+// ============================================================================
+// TEST 29: Bounded window
+// PURPOSE: Runs a capacity-limited sequence as a sliding window from both ends,
+//          checking eviction order, recycling, and interaction with undo
+// ============================================================================
+void testBoundedWindow() {
+    cout << "TEST 29: Bounded window" << endl;
+    Sequence s;
+    s.set_capacity(3);
+    assert(s.capacity() == 3);
+    for (int i = 0; i < 10; i++) s.push_back(to_string(i));
+    assert(show(s) == "<7, 8, 9>/3");             // Oldest items were evicted
+
+    s.push_front("a");                            // Full: evicts from the back
+    assert(show(s) == "<a, 7, 8>/3");
+    s.pop_front();
+    s.pop_back();
+    assert(show(s) == "<7>/1");
+    s.push_front("b");
+    s.push_back("c");
+    s.push_back("d");                             // Evicts b
+    assert(show(s) == "<7, c, d>/3");
+
+    s.insert(1, "x");                             // Inserts also respect the limit
+    assert(show(s) == "<x, c, d>/3");
+
+    bool threw = false;
+    Sequence e;
+    try { e.pop_front(); } catch (const std::runtime_error&) { threw = true; }
+    assert(threw);
+
+    Sequence w(5);                                // Gaps shrink from the front
+    w.set_capacity(4);
+    assert(w.size() == 4);
+    w.push_back("z");
+    assert(w.size() == 4 && w.back() == "z" && w[0] == "");
+
+    s.begin_transaction();                        // Evictions inside a transaction roll back
+    s.push_back("t1");
+    s.push_back("t2");
+    assert(show(s) == "<d, t1, t2>/3");
+    s.rollback();
+    assert(show(s) == "<x, c, d>/3");
+
+    Sequence copy = s;                            // Capacity travels with the copy
+    copy.push_back("y");
+    assert(show(copy) == "<c, d, y>/3" && show(s) == "<x, c, d>/3");
+
+    s.set_capacity(1);
+    assert(show(s) == "<d>/1");
+    s.set_capacity(0);                            // Unbounded again
+    for (int i = 0; i < 5; i++) s.push_back(to_string(i));
+    assert(s.size() == 6);
+
+    Sequence r;                                   // Capacity changes roll back too
+    for (int i = 0; i < 5; i++) r.push_back(to_string(i));
+    r.begin_transaction();
+    r.set_capacity(2);
+    r.rollback();
+    assert(r.capacity() == 0 && r.size() == 5);
+    r.set_capacity(2);
+    r.begin_transaction();
+    r.set_capacity(0);
+    r.push_back("5");
+    r.rollback();
+    assert(r.capacity() == 2);
+    r.push_back("6");
+    assert(show(r) == "<4, 6>/2");
+
+    Sequence ordered;                             // Ordered inserts evict from the front
+    ordered.set_capacity(2);
+    for (const char* w : {"b", "c", "d", "e", "f", "g", "a"}) ordered.insert_sorted(w);
+    assert(show(ordered) == "<f, g>/2");
+    ordered.insert_sorted("h");
+    assert(show(ordered) == "<g, h>/2");
+
+    Sequence big;                                 // Long run against a reference
+    big.set_capacity(100);
+    vector<string> ref;
+    for (int i = 0; i < 5000; i++) {
+        string v = to_string(i);
+        if (i % 7 == 3) {
+            big.push_front(v);
+            ref.insert(ref.begin(), v);
+            if (ref.size() > 100) ref.pop_back();
+        } else if (i % 11 == 5 && !ref.empty()) {
+            big.pop_front();
+            ref.erase(ref.begin());
+        } else {
+            big.push_back(v);
+            ref.push_back(v);
+            if (ref.size() > 100) ref.erase(ref.begin());
+        }
+    }
+    assert(big.size() == ref.size());
+    for (size_t i = 0; i < ref.size(); i++) assert(big[i] == ref[i]);
+    cout << "Window: " << s << endl;
+    cout << "PASS" << endl << endl;
+}
+
+// ============================================================================
+// TEST 30: Reverse and rotate
+// PURPOSE: Verifies the lazy orientation against a vector while every kind of
+//          modification is mixed in, including gaps, the bounded window and
+//          rolled-back transactions
+// ============================================================================
+void checkAgainst(Sequence& s, const vector<string>& ref) {
+    assert(s.size() == ref.size());
+    for (size_t i = 0; i < ref.size(); i++) assert(s[i] == ref[i]);
+    if (!ref.empty()) assert(s.front() == ref.front() && s.back() == ref.back());
+    vector<size_t> twoChars;                      // Scans report positions, not chain slots
+    for (size_t i = 0; i < ref.size(); i++)
+        if (ref[i].size() == 2) twoChars.push_back(i);
+    assert(s.positions_with_length(2) == twoChars);
+}
+
+void testReverseRotate() {
+    cout << "TEST 30: Reverse and rotate" << endl;
+    Sequence s;
+    for (int i = 1; i <= 5; i++) s.push_back(to_string(i));
+    s.reverse();
+    assert(show(s) == "<5, 4, 3, 2, 1>/5");
+    s.rotate(2);
+    assert(show(s) == "<3, 2, 1, 5, 4>/5");
+    s.push_back("a");
+    s.push_front("b");
+    assert(show(s) == "<b, 3, 2, 1, 5, 4, a>/7");
+    s.reverse();
+    s.pop_back();
+    s.pop_front();
+    assert(show(s) == "<4, 5, 1, 2, 3>/5");
+    assert(s.find("1") == 2);
+
+    s.begin_transaction();                        // Orientation changes roll back with everything else
+    s.rotate(3);
+    s.insert(1, "x");
+    s.reverse();
+    s.erase(0, 2);
+    s.sort();
+    s.rollback();
+    assert(show(s) == "<4, 5, 1, 2, 3>/5");
+
+    Sequence copy = s;                            // Copies keep the order they see
+    copy.rotate(4);
+    assert(show(copy) == "<3, 4, 5, 1, 2>/5" && show(s) == "<4, 5, 1, 2, 3>/5");
+
+    unsigned state = 7;                           // Small deterministic generator
+    auto next = [&state](unsigned bound) { state = state * 1103515245u + 12345u; return (state >> 8) % bound; };
+    Sequence m(20);                               // Starts as one gap
+    vector<string> ref(20);
+    for (int step = 0; step < 3000; step++) {
+        string v = to_string(next(100));
+        size_t n = ref.size();
+        switch (next(12)) {
+        case 0: m.push_back(v); ref.push_back(v); break;
+        case 1: m.push_front(v); ref.insert(ref.begin(), v); break;
+        case 2: if (n) { m.pop_back(); ref.pop_back(); } break;
+        case 3: if (n) { m.pop_front(); ref.erase(ref.begin()); } break;
+        case 4: { size_t p = next(n + 1); m.insert(p, v); ref.insert(ref.begin() + p, v); break; }
+        case 5: if (n > 1) { size_t p = next(n - 1); m.erase(p, 2); ref.erase(ref.begin() + p, ref.begin() + p + 2); } break;
+        case 6: if (n) { size_t p = next(n); m[p] = v; ref[p] = v; } break;
+        case 7: m.reverse(); reverse(ref.begin(), ref.end()); break;
+        case 8: if (n) { size_t k = next(2 * n); m.rotate(k); rotate(ref.begin(), ref.begin() + k % n, ref.end()); } break;
+        case 9: {                                 // Append a rotated sequence
+            Sequence o;
+            vector<string> extra{v, "t" + v, "u" + v};
+            for (const auto& e : extra) o.push_back(e);
+            o.rotate(1);
+            rotate(extra.begin(), extra.begin() + 1, extra.end());
+            m.append(std::move(o));
+            ref.insert(ref.end(), extra.begin(), extra.end());
+            break;
+        }
+        case 10:                                  // Sorted phase with ordered inserts
+            if (next(10) == 0) {
+                m.sort(); stable_sort(ref.begin(), ref.end());
+                m.insert_sorted(v); ref.insert(upper_bound(ref.begin(), ref.end(), v), v);
+            }
+            break;
+        case 11: {                                // Rolled-back burst of mixed edits
+            m.begin_transaction();
+            m.reverse();
+            m.push_back(v);
+            if (n) m.rotate(next(n));
+            m.erase(0);
+            m.rollback();
+            break;
+        }
+        }
+        if (ref.size() > 300) { m.clear(); ref.clear(); }
+        if (step % 50 == 0) checkAgainst(m, ref);
+    }
+    checkAgainst(m, ref);
+
+    Sequence w;                                   // Bounded window evicts the logical front
+    w.set_capacity(3);
+    for (int i = 0; i < 5; i++) w.push_back(to_string(i));
+    w.reverse();
+    w.push_back("r");                             // Front is 4 now, so 4 is evicted
+    assert(show(w) == "<3, 2, r>/3");
+    cout << "Sequence: " << s << endl;
+    cout << "PASS" << endl << endl;
+}
+
+// ============================================================================
+// TEST 31: Trace record and replay
+// PURPOSE: Records a workload over several sequences (one created before
+//          recording starts), replays it and checks the replay ends in the
+//          same state; also checks a replay notices a different outcome
+// ============================================================================
+void testTraceReplay() {
+    cout << "TEST 31: Trace record and replay" << endl;
+    Sequence early;                               // Exists before recording: loaded whole
+    early.push_back("e1");
+    early.push_back("e2");
+
+    ostringstream trace;
+    SequenceTrace::start(trace);
+    {
+        Sequence a(4);
+        a[1] = "x";                               // Write through operator[]
+        a.push_back("b");
+        a.insert(0, "c");
+        a.erase(2);
+        bool threw = false;
+        try { a.erase(99); } catch (const std::out_of_range&) { threw = true; }
+        assert(threw);
+        Sequence b = a;                           // Copy
+        b.reverse();
+        b.rotate(1);
+        b.push_front("f");
+        a.append(std::move(early));
+        a.begin_transaction();
+        a.push_back("rolled back");
+        a.rollback();
+        Sequence c(std::move(b));                 // Move
+        c.sort();
+        c.insert_sorted("d");
+        assert(a.find("b") != Sequence::npos && a.front() == "c" && a.at(0) == "c");
+        ostringstream printed;
+        printed << c;
+        a.set_capacity(5);
+        a.pop_front();
+        early = c;                                // Copy assignment into the early sequence
+    }
+    SequenceTrace::stop();
+    assert(!SequenceTrace::recording());
+
+    istringstream in(trace.str());
+    TraceReplay replay(in);
+    replay.run();
+    assert(replay.checked() == 1);                // Only early is still alive
+    assert(replay.mismatches() == 0);
+    assert(replay.stats(TraceOp::PushBack).count == 2);
+    assert(replay.stats(TraceOp::Store).count == 1);
+    assert(replay.stats(TraceOp::At).count == 1);
+    assert(replay.stats(TraceOp::Erase).count == 2 && replay.stats(TraceOp::Erase).errors == 1);
+    assert(replay.stats(TraceOp::Destroy).count == 3);
+
+    string bytes = trace.str();                   // Change the last item written before stop()
+    ostringstream other;
+    SequenceTrace::start(other);
+    { Sequence d; d.push_back("same"); early = d; }
+    SequenceTrace::stop();
+    string tampered = other.str();
+    tampered[tampered.find("same")] = 'S';
+    istringstream tamperedIn(tampered);
+    TraceReplay check(tamperedIn);
+    check.run();
+    assert(check.checked() == 1 && check.mismatches() == 1);
+
+    Sequence held;                                // Loaded with a different chain layout
+    held.push_back("");
+    held.push_back("x");
+    ostringstream snapTrace;
+    SequenceTrace::start(snapTrace);
+    held.begin_transaction();
+    held[0] = "a";
+    Sequence::Snapshot snap = held.snapshot();
+    held[1] = "b";
+    held.rollback(snap);                          // Named by ordinal, not by log length
+    held.commit();
+    SequenceTrace::stop();
+    assert(show(held) == "<a, x>/2");
+    istringstream snapIn(snapTrace.str());
+    TraceReplay snapReplay(snapIn);
+    snapReplay.run();
+    assert(snapReplay.checked() == 1 && snapReplay.mismatches() == 0);
+    assert(snapReplay.stats(TraceOp::RollbackTo).count == 1 && snapReplay.stats(TraceOp::RollbackTo).errors == 0);
+    cout << "Trace bytes: " << bytes.size() << endl;
+    cout << "PASS" << endl << endl;
+}
+
 // ============================================================================
 // MAIN FUNCTION
 // PURPOSE: Runs all test cases sequentially and reports status to console.
@@ -344,6 +943,16 @@ int main() {
     testCopyConstructor();
     testMemoryLeaks();
     testOutputFormat();
+    testLazySized();
+    testSortAndMerge();
+    testInsertSorted();
+    testGapSequence();
+    testTransactions();
+    testIngest();
+    testPhaseChanges();
+    testBoundedWindow();
+    testReverseRotate();
+    testTraceReplay();
 
     cout << "ALL TESTS PASSED!" << endl;
     return 0;
@@ -0,0 +1,81 @@
+/* Name : Nikhitha Palakurla
+Project Name and Description : Sequence Project
+streaming ingestion pipeline that fills a Sequence from a stream using
+coroutine stages, overlapping reads with record splitting */
+
+#include "SequenceIngest.h"  // Include pipeline declarations
+#include <functional>        // Provides std::ref
+#include <future>            // Provides std::async for read-ahead
+
+// ============================================================================
+// readChunks - reads the next chunk on a worker thread while the consumer
+// works on the current one
+// ============================================================================
+Generator<std::string_view> readChunks(std::istream& in, size_t chunkSize) {
+    if (chunkSize == 0)                             // A zero-byte read would never advance
+        throw std::invalid_argument("Chunk size must be positive");
+
+    auto fill = [&in, chunkSize](std::string& buffer) {
+        buffer.resize(chunkSize);                   // Only the first fill allocates
+        in.read(buffer.data(), static_cast<std::streamsize>(chunkSize));
+        buffer.resize(static_cast<size_t>(in.gcount())); // Short read at end of stream
+    };
+
+    std::string buffers[2];                         // One being parsed, one being filled
+    size_t current = 0;
+    auto pending = std::async(std::launch::async, fill, std::ref(buffers[current]));
+    while (true) {
+        pending.get();                              // Wait for the read in flight
+        if (buffers[current].empty())               // End of stream
+            co_return;
+        pending = std::async(std::launch::async, fill, std::ref(buffers[1 - current])); // Read ahead
+        co_yield std::string_view(buffers[current]);
+        current = 1 - current;                      // Consumer is done with this buffer
+    }
+}
+
+// ============================================================================
+// splitRecords - cuts chunks into records; a record may span chunk borders
+// ============================================================================
+Generator<Sequence> splitRecords(Generator<std::string_view> chunks, size_t batchSize) {
+    if (batchSize == 0)                             // Batches would never fill
+        throw std::invalid_argument("Batch size must be positive");
+
+    Sequence batch;                                 // Nodes are built here, off the target
+    std::string partial;                            // Unterminated record from earlier chunks
+
+    while (chunks.next()) {
+        std::string_view chunk = chunks.value();
+        size_t start = 0;
+        for (size_t end; (end = chunk.find('\n', start)) != std::string_view::npos; start = end + 1) {
+            if (partial.empty()) {
+                batch.push_back(std::string(chunk.substr(start, end - start)));
+            } else {                                // Finish the record carried over
+                partial.append(chunk.substr(start, end - start));
+                batch.push_back(std::move(partial));
+                partial.clear();
+            }
+            if (batch.size() == batchSize)          // Hand over a full batch
+                co_yield std::exchange(batch, Sequence());
+        }
+        partial.append(chunk.substr(start));        // Keep the tail for the next chunk
+    }
+
+    if (!partial.empty())                           // Last line without a newline
+        batch.push_back(std::move(partial));
+    if (!batch.empty())
+        co_yield std::move(batch);
+}
+
+// ============================================================================
+// ingest - splices finished batches onto the target
+// ============================================================================
+size_t ingest(Sequence& target, std::istream& in, size_t chunkSize, size_t batchSize) {
+    size_t records = 0;
+    auto batches = splitRecords(readChunks(in, chunkSize), batchSize);
+    while (batches.next()) {
+        records += batches.value().size();
+        target.append(std::move(batches.value()));  // O(1) splice of the prepared nodes
+    }
+    return records;
+}
@@ -0,0 +1,71 @@
+#ifndef SEQUENCE_INGEST_H
+#define SEQUENCE_INGEST_H
+
+#include <coroutine>                // Provides C++20 coroutine support
+#include <exception>                // Provides std::exception_ptr
+#include <iostream>
+#include <optional>                 // Provides storage for the yielded value
+#include <string>                   // Provides std::string class
+#include <string_view>              // Provides views of the read buffers
+#include <utility>                  // Provides std::exchange, std::move
+#include "Sequence.h"               // Provides the Sequence being filled
+// SequenceIngest - Streaming, line-oriented loading of a Sequence
+//
+// Loading runs as a pipeline of coroutine stages: readChunks pulls large
+// buffers from the stream (the next read runs on a worker thread while the
+// current buffer is parsed), splitRecords cuts buffers into newline-separated
+// records and builds them into batches of ready-made nodes, and ingest splices
+// each finished batch onto the target with Sequence::append. Records match
+// std::getline: '\n' separates them and a final unterminated line is kept.
+
+// Generator - minimal pull-based coroutine generator (std::generator is C++23)
+template <typename T>
+class Generator {
+public:
+    struct promise_type {
+        std::optional<T> current;                   // Most recently yielded value
+        std::exception_ptr error;                   // Exception escaping the coroutine body
+
+        Generator get_return_object() { return Generator(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; } // Start lazily on first next()
+        std::suspend_always final_suspend() noexcept { return {}; }
+        std::suspend_always yield_value(T value) {  // Hand value to the consumer and pause
+            current = std::move(value);
+            return {};
+        }
+        void return_void() {}
+        void unhandled_exception() { error = std::current_exception(); }
+    };
+
+    explicit Generator(std::coroutine_handle<promise_type> h) : handle(h) {}
+    Generator(Generator&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    Generator(const Generator&) = delete;
+    Generator& operator=(const Generator&) = delete;
+    ~Generator() { if (handle) handle.destroy(); }  // Destroys the suspended frame
+
+    // Resumes the coroutine; returns false once it has finished
+    bool next() {
+        handle.promise().current.reset();
+        handle.resume();
+        if (handle.promise().error)                 // Surface producer exceptions to the consumer
+            std::rethrow_exception(handle.promise().error);
+        return !handle.done();
+    }
+
+    T& value() { return *handle.promise().current; } // Value produced by the last next()
+
+private:
+    std::coroutine_handle<promise_type> handle;
+};
+
+// Stage 1: yields successive chunks of up to chunkSize bytes, reading ahead in the background.
+// Two buffers are reused, so each view is only valid until the following chunk is requested.
+Generator<std::string_view> readChunks(std::istream& in, size_t chunkSize);
+
+// Stage 2: yields Sequences of up to batchSize records cut from the chunks
+Generator<Sequence> splitRecords(Generator<std::string_view> chunks, size_t batchSize);
+
+// Stage 3: appends every record of in to target; returns the number of records added
+size_t ingest(Sequence& target, std::istream& in, size_t chunkSize = 1 << 20, size_t batchSize = 4096);
+
+#endif // SEQUENCE_INGEST_H
@@ -0,0 +1,34 @@
+#include <fstream>         // For reading the trace file
+#include <iostream>        // For console I/O
+#include "SequenceTrace.h" // Includes the trace format and replayer
+
+using namespace std;
+
+// ============================================================================
+// MAIN FUNCTION
+// PURPOSE: Replays a trace recorded by a SEQUENCE_TRACE build against this
+//          build of Sequence, prints per-operation latency histograms and
+//          exits non-zero if any Sequence ends up in a different state.
+// ============================================================================
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        cerr << "usage: " << argv[0] << " <trace file>" << endl;
+        return 2;
+    }
+    ifstream in(argv[1], ios::binary);
+    if (!in) {
+        cerr << "Cannot open " << argv[1] << endl;
+        return 2;
+    }
+
+    try {
+        TraceReplay replay(in);
+        replay.run();
+        cout << "SEQUENCE REPLAY " << argv[1] << endl << endl;
+        replay.report(cout);
+        return replay.mismatches() ? 1 : 0;
+    } catch (const exception& e) {
+        cerr << "Replay failed: " << e.what() << endl;
+        return 2;
+    }
+}
@@ -0,0 +1,575 @@
+/* Name : Nikhitha Palakurla
+Project Name and Description : Sequence Project
+operation trace recorder for Sequence and a replayer that re-executes a
+trace, timing each operation and checking the final state */
+
+#include "SequenceTrace.h"  // Include recorder and replayer declarations
+#include <algorithm>        // Provides std::sort, std::max
+#include <bit>              // Provides std::bit_width for histogram buckets
+#include <chrono>           // Provides the replay clock
+#include <iomanip>          // Provides report formatting
+#include <sstream>          // Provides the sink for replayed operator<<
+#include <stdexcept>        // Provides std::runtime_error
+
+static const char traceMagic[8] = {'S', 'E', 'Q', 'T', 'R', 'A', 'C', 'E'};
+static const char traceVersion = 2;
+static volatile size_t replaySink = 0;              // Keeps results of replayed reads observable
+
+const char* traceOpName(TraceOp op) {
+    static const char* const names[] = {
+        "construct", "copy", "move", "copy assign", "move assign", "destroy", "load",
+        "operator[]", "store", "push_back", "pop_back", "push_front", "pop_front", "insert",
+        "erase", "clear", "append", "set_capacity", "reverse", "rotate", "sort", "merge",
+        "insert_sorted", "begin_transaction", "commit", "rollback", "rollback(snapshot)",
+        "snapshot", "at", "front", "back", "find", "positions_with_length", "positions_with_prefix",
+        "operator<<", "final"};
+    static_assert(sizeof(names) / sizeof(names[0]) == static_cast<size_t>(TraceOp::Count));
+    return names[static_cast<size_t>(op)];
+}
+
+// ============================================================================
+// Encoding - LEB128 varints and length-prefixed strings
+// ============================================================================
+void SequenceTrace::writeVarint(std::ostream& out, uint64_t value) {
+    while (value >= 0x80) {                         // Seven bits per byte, high bit = more follow
+        out.put(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.put(static_cast<char>(value));
+}
+
+uint64_t SequenceTrace::readVarint(std::istream& in) {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int byte = in.get();
+        if (byte == std::char_traits<char>::eof())
+            throw std::runtime_error("Truncated trace");
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return value;
+    }
+    throw std::runtime_error("Malformed trace");
+}
+
+void SequenceTrace::writeString(std::ostream& out, const std::string& text) {
+    writeVarint(out, text.size());
+    out.write(text.data(), static_cast<std::streamsize>(text.size()));
+}
+
+std::string SequenceTrace::readString(std::istream& in) {
+    std::string text(readVarint(in), '\0');
+    in.read(text.data(), static_cast<std::streamsize>(text.size()));
+    if (static_cast<size_t>(in.gcount()) != text.size())
+        throw std::runtime_error("Truncated trace");
+    return text;
+}
+
+// ============================================================================
+// Recording
+// ============================================================================
+std::ostream* SequenceTrace::out = nullptr;
+thread_local int SequenceTrace::depth = 0;
+std::unordered_map<const Sequence*, uint64_t> SequenceTrace::ids;
+uint64_t SequenceTrace::nextId = 0;
+thread_local std::string* SequenceTrace::pendingItem = nullptr;
+thread_local std::string SequenceTrace::pendingValue;
+thread_local uint64_t SequenceTrace::pendingOwner = 0;
+std::unordered_map<const Sequence*, SequenceTrace::Snapshots> SequenceTrace::snapshots;
+
+void SequenceTrace::start(std::ostream& stream) {
+    if (out)
+        throw std::runtime_error("A trace is already being recorded");
+    out = &stream;
+    out->write(traceMagic, sizeof(traceMagic));
+    out->put(traceVersion);
+    ids.clear();
+    snapshots.clear();
+    nextId = 0;
+    pendingItem = nullptr;
+}
+
+void SequenceTrace::stop() {
+    if (!out)
+        return;
+    flushStore();
+    std::vector<std::pair<uint64_t, const Sequence*>> live; // Id order keeps traces reproducible
+    for (const auto& [s, id] : ids)
+        live.emplace_back(id, s);
+    std::sort(live.begin(), live.end());
+    for (const auto& [id, s] : live) {
+        out->put(static_cast<char>(TraceOp::Final));
+        writeVarint(*out, id);
+        writeVarint(*out, s->size());
+        writeVarint(*out, fingerprint(*s));
+    }
+    out->flush();
+    out = nullptr;
+    ids.clear();
+    snapshots.clear();
+}
+
+bool SequenceTrace::recording() {
+    return out != nullptr;
+}
+
+void SequenceTrace::record(TraceOp op, const Sequence* s, std::initializer_list<uint64_t> args,
+                           const std::string* text) {
+    flushStore();                                   // A write through operator[] happened first
+    uint64_t id;
+    if (op == TraceOp::Construct || op == TraceOp::Copy) {
+        id = nextId++;
+        ids[s] = id;                                // Replaces a destroyed Sequence at the same address
+        forget(s);
+    } else if (op == TraceOp::Destroy) {
+        auto it = ids.find(s);
+        if (it == ids.end())                        // Never touched while recording
+            return;
+        id = it->second;
+        ids.erase(it);
+        forget(s);
+    } else {
+        id = idOf(s);
+    }
+    out->put(static_cast<char>(op));
+    writeVarint(*out, id);
+    for (uint64_t arg : args)
+        writeVarint(*out, arg);
+    if (text)
+        writeString(*out, *text);
+}
+
+void SequenceTrace::recordMove(const Sequence* s, const Sequence* source) {
+    flushStore();
+    auto it = ids.find(source);
+    if (it == ids.end()) {                          // Source predates the trace and is empty now,
+        ids.erase(s);                               // so s is written out whole instead
+        forget(s);
+        idOf(s);
+        return;
+    }
+    uint64_t sourceId = it->second;
+    uint64_t id = nextId++;
+    ids[s] = id;
+    forget(s);
+    out->put(static_cast<char>(TraceOp::Move));
+    writeVarint(*out, id);
+    writeVarint(*out, sourceId);
+}
+
+void SequenceTrace::trackStore(const Sequence* s, std::string& item) {
+    pendingItem = &item;
+    pendingValue = item;
+    pendingOwner = ids[s];                          // Recorded by the Index just before
+}
+
+void SequenceTrace::recordSnapshot(const Sequence* s, const Sequence::Snapshot& snap) {
+    record(TraceOp::Snapshot, s);
+    Snapshots& taken = snapshots[s];
+    taken.byMark[{snap.mark, snap.generation}] = taken.taken++; // Equal keys name the same state
+}
+
+uint64_t SequenceTrace::snapshotOf(const Sequence* s, const Sequence::Snapshot& snap) {
+    if (snap.owner != s)                            // Rejected by rollback anyway
+        return noSnapshot;
+    auto it = snapshots.find(s);
+    if (it == snapshots.end())
+        return noSnapshot;
+    auto found = it->second.byMark.find({snap.mark, snap.generation});
+    return found == it->second.byMark.end() ? noSnapshot : found->second;
+}
+
+void SequenceTrace::forget(const Sequence* s) {
+    snapshots.erase(s);
+}
+
+void SequenceTrace::flushStore() {
+    if (!pendingItem)
+        return;
+    if (*pendingItem != pendingValue) {             // Caller wrote through the reference
+        out->put(static_cast<char>(TraceOp::Store));
+        writeVarint(*out, pendingOwner);
+        writeString(*out, *pendingItem);
+    }
+    pendingItem = nullptr;
+}
+
+uint64_t SequenceTrace::idOf(const Sequence* s) {
+    auto it = ids.find(s);
+    if (it != ids.end())
+        return it->second;
+
+    flushStore();
+    uint64_t id = nextId++;                         // Existed before start(): write it out whole
+    ids[s] = id;
+    std::vector<std::pair<size_t, std::string>> items;
+    visit(*s, [&](size_t position, const std::string& item) {
+        if (!item.empty()) items.emplace_back(position, item); // Empty slots come back as a gap
+    });
+    out->put(static_cast<char>(TraceOp::Load));
+    writeVarint(*out, id);
+    writeVarint(*out, s->size());
+    writeVarint(*out, s->capacity());
+    writeVarint(*out, items.size());
+    for (const auto& [pos, item] : items) {
+        writeVarint(*out, pos);
+        writeString(*out, item);
+    }
+    return id;
+}
+
+// Drains a copy through the public interface, so the trace does not depend on
+// how Sequence stores its items and the reads leave s (and its log) alone.
+// front() and pop_front() are O(1), even on a run of empty slots.
+template <typename Fn>
+void SequenceTrace::visit(const Sequence& s, Fn&& fn) {
+    Scope quiet;                                    // Copying and reading are not part of the trace
+    Sequence copy(s);
+    for (size_t position = 0; !copy.empty(); ++position) {
+        fn(position, copy.front());
+        copy.pop_front();
+    }
+}
+
+uint64_t SequenceTrace::fingerprint(const Sequence& s) {
+    uint64_t hash = 14695981039346656037ull;        // FNV-1a
+    auto mix = [&hash](unsigned char byte) { hash = (hash ^ byte) * 1099511628211ull; };
+    visit(s, [&](size_t, const std::string& item) {
+        for (int b = 0; b < 64; b += 8)             // Length first, so item borders count
+            mix(static_cast<unsigned char>(item.size() >> b));
+        for (char c : item)
+            mix(static_cast<unsigned char>(c));
+    });
+    return hash;
+}
+
+// ============================================================================
+// Replay
+// ============================================================================
+TraceReplay::TraceReplay(std::istream& stream)
+    : in(stream), lastRef(nullptr), opStats(static_cast<size_t>(TraceOp::Count)),
+      finalChecked(0), finalMismatched(0) {
+    char magic[sizeof(traceMagic)];
+    in.read(magic, sizeof(magic));
+    if (in.gcount() != sizeof(magic) || !std::equal(magic, magic + sizeof(magic), traceMagic))
+        throw std::runtime_error("Not a Sequence trace");
+    if (in.get() != traceVersion)
+        throw std::runtime_error("Unsupported trace version");
+}
+
+void TraceReplay::run() {
+    while (true) {
+        int op = in.get();
+        if (op == std::char_traits<char>::eof())
+            return;
+        if (op >= static_cast<int>(TraceOp::Count))
+            throw std::runtime_error("Unknown trace record");
+        execute(static_cast<TraceOp>(op));
+    }
+}
+
+Sequence& TraceReplay::object(uint64_t id) {
+    auto it = objects.find(id);
+    if (it == objects.end())
+        throw std::runtime_error("Trace refers to an unknown sequence");
+    return it->second;
+}
+
+void TraceReplay::execute(TraceOp op) {
+    using Clock = std::chrono::steady_clock;
+    OpStats& st = opStats[static_cast<size_t>(op)];
+    auto timed = [&st](auto&& fn) {                 // Operands are read before the clock starts
+        auto start = Clock::now();
+        try {
+            fn();
+        } catch (const std::exception&) {           // Recorded calls may have thrown too
+            ++st.errors;
+        }
+        uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+        size_t bucket = ns ? std::bit_width(ns) - 1 : 0;
+        if (st.buckets.size() <= bucket) st.buckets.resize(bucket + 1);
+        ++st.buckets[bucket];
+        ++st.count;
+        st.totalNs += ns;
+    };
+    auto fresh = [this](uint64_t id) -> uint64_t {
+        if (objects.count(id))
+            throw std::runtime_error("Trace reuses a live sequence id");
+        snapshots.erase(id);
+        return id;
+    };
+
+    uint64_t id = SequenceTrace::readVarint(in);
+    switch (op) {
+    case TraceOp::Construct: {
+        size_t size = SequenceTrace::readVarint(in);
+        fresh(id);
+        timed([&] { objects.try_emplace(id, size); });
+        break;
+    }
+    case TraceOp::Copy: {
+        Sequence& source = object(SequenceTrace::readVarint(in));
+        fresh(id);
+        timed([&] { objects.try_emplace(id, source); });
+        break;
+    }
+    case TraceOp::Move: {
+        Sequence& source = object(SequenceTrace::readVarint(in));
+        fresh(id);
+        timed([&] { objects.try_emplace(id, std::move(source)); });
+        break;
+    }
+    case TraceOp::CopyAssign: {
+        Sequence& target = object(id);
+        Sequence& source = object(SequenceTrace::readVarint(in));
+        timed([&] { target = source; });
+        break;
+    }
+    case TraceOp::MoveAssign: {
+        Sequence& target = object(id);
+        Sequence& source = object(SequenceTrace::readVarint(in));
+        timed([&] { target = std::move(source); });
+        break;
+    }
+    case TraceOp::Destroy:
+        object(id);
+        timed([&] { objects.erase(id); });
+        break;
+    case TraceOp::Load: {                           // State from before recording started: not timed
+        size_t size = SequenceTrace::readVarint(in);
+        size_t cap = SequenceTrace::readVarint(in);
+        size_t n = SequenceTrace::readVarint(in);
+        Sequence& s = objects.try_emplace(fresh(id), size).first->second;
+        s.set_capacity(cap);
+        for (size_t i = 0; i < n; ++i) {
+            size_t position = SequenceTrace::readVarint(in);
+            s[position] = SequenceTrace::readString(in);
+        }
+        break;
+    }
+    case TraceOp::Index: {
+        Sequence& s = object(id);
+        size_t position = SequenceTrace::readVarint(in);
+        lastRef = nullptr;
+        timed([&] { lastRef = &s[position]; });
+        break;
+    }
+    case TraceOp::Store: {
+        object(id);
+        std::string item = SequenceTrace::readString(in);
+        if (!lastRef)
+            throw std::runtime_error("Store without a preceding operator[]");
+        timed([&] { *lastRef = std::move(item); });
+        lastRef = nullptr;
+        break;
+    }
+    case TraceOp::PushBack: {
+        Sequence& s = object(id);
+        std::string item = SequenceTrace::readString(in);
+        timed([&] { s.push_back(std::move(item)); });
+        break;
+    }
+    case TraceOp::PopBack: {
+        Sequence& s = object(id);
+        timed([&] { s.pop_back(); });
+        break;
+    }
+    case TraceOp::PushFront: {
+        Sequence& s = object(id);
+        std::string item = SequenceTrace::readString(in);
+        timed([&] { s.push_front(std::move(item)); });
+        break;
+    }
+    case TraceOp::PopFront: {
+        Sequence& s = object(id);
+        timed([&] { s.pop_front(); });
+        break;
+    }
+    case TraceOp::Insert: {
+        Sequence& s = object(id);
+        size_t position = SequenceTrace::readVarint(in);
+        std::string item = SequenceTrace::readString(in);
+        timed([&] { s.insert(position, std::move(item)); });
+        break;
+    }
+    case TraceOp::Erase: {
+        Sequence& s = object(id);
+        size_t position = SequenceTrace::readVarint(in);
+        size_t count = SequenceTrace::readVarint(in);
+        timed([&] { s.erase(position, count); });
+        break;
+    }
+    case TraceOp::Clear: {
+        Sequence& s = object(id);
+        timed([&] { s.clear(); });
+        break;
+    }
+    case TraceOp::Append: {
+        Sequence& s = object(id);
+        Sequence& other = object(SequenceTrace::readVarint(in));
+        timed([&] { s.append(std::move(other)); });
+        break;
+    }
+    case TraceOp::SetCapacity: {
+        Sequence& s = object(id);
+        size_t cap = SequenceTrace::readVarint(in);
+        timed([&] { s.set_capacity(cap); });
+        break;
+    }
+    case TraceOp::Reverse: {
+        Sequence& s = object(id);
+        timed([&] { s.reverse(); });
+        break;
+    }
+    case TraceOp::Rotate: {
+        Sequence& s = object(id);
+        size_t k = SequenceTrace::readVarint(in);
+        timed([&] { s.rotate(k); });
+        break;
+    }
+    case TraceOp::Sort: {
+        Sequence& s = object(id);
+        timed([&] { s.sort(); });
+        break;
+    }
+    case TraceOp::Merge: {
+        Sequence& s = object(id);
+        Sequence& other = object(SequenceTrace::readVarint(in));
+        timed([&] { s.merge(std::move(other)); });
+        break;
+    }
+    case TraceOp::InsertSorted: {
+        Sequence& s = object(id);
+        std::string item = SequenceTrace::readString(in);
+        timed([&] { s.insert_sorted(std::move(item)); });
+        break;
+    }
+    case TraceOp::Begin: {
+        Sequence& s = object(id);
+        timed([&] { s.begin_transaction(); });
+        break;
+    }
+    case TraceOp::Commit: {
+        Sequence& s = object(id);
+        timed([&] { s.commit(); });
+        break;
+    }
+    case TraceOp::Rollback: {
+        Sequence& s = object(id);
+        timed([&] { s.rollback(); });
+        break;
+    }
+    case TraceOp::RollbackTo: {
+        Sequence& s = object(id);
+        uint64_t ordinal = SequenceTrace::readVarint(in);
+        const std::vector<Sequence::Snapshot>& taken = snapshots[id];
+        Sequence::Snapshot snap{};                  // Unknown handles replay as invalid ones
+        if (ordinal < taken.size())
+            snap = taken[ordinal];
+        timed([&] { s.rollback(snap); });
+        break;
+    }
+    case TraceOp::Snapshot: {
+        Sequence& s = object(id);
+        std::vector<Sequence::Snapshot>& taken = snapshots[id];
+        taken.emplace_back();                       // Keeps ordinals in step if it throws
+        timed([&] { taken.back() = s.snapshot(); });
+        break;
+    }
+    case TraceOp::At: {
+        Sequence& s = object(id);
+        size_t position = SequenceTrace::readVarint(in);
+        timed([&] { replaySink = replaySink + s.at(position).size(); });
+        break;
+    }
+    case TraceOp::Front: {
+        Sequence& s = object(id);
+        timed([&] { replaySink = replaySink + s.front().size(); });
+        break;
+    }
+    case TraceOp::Back: {
+        Sequence& s = object(id);
+        timed([&] { replaySink = replaySink + s.back().size(); });
+        break;
+    }
+    case TraceOp::Find: {
+        Sequence& s = object(id);
+        size_t from = SequenceTrace::readVarint(in);
+        std::string item = SequenceTrace::readString(in);
+        timed([&] { replaySink = replaySink + s.find(item, from); });
+        break;
+    }
+    case TraceOp::PositionsWithLength: {
+        Sequence& s = object(id);
+        size_t length = SequenceTrace::readVarint(in);
+        timed([&] { replaySink = replaySink + s.positions_with_length(length).size(); });
+        break;
+    }
+    case TraceOp::PositionsWithPrefix: {
+        Sequence& s = object(id);
+        std::string prefix = SequenceTrace::readString(in);
+        timed([&] { replaySink = replaySink + s.positions_with_prefix(prefix).size(); });
+        break;
+    }
+    case TraceOp::Print: {
+        Sequence& s = object(id);
+        timed([&] {
+            std::ostringstream text;                // Formatting cost without the console
+            text << s;
+            replaySink = replaySink + text.tellp();
+        });
+        break;
+    }
+    case TraceOp::Final: {
+        size_t size = SequenceTrace::readVarint(in);
+        uint64_t hash = SequenceTrace::readVarint(in);
+        ++finalChecked;
+        auto it = objects.find(id);
+        if (it == objects.end() || it->second.size() != size || SequenceTrace::fingerprint(it->second) != hash)
+            ++finalMismatched;
+        break;
+    }
+    case TraceOp::Count:
+        throw std::runtime_error("Unknown trace record");
+    }
+}
+
+const TraceReplay::OpStats& TraceReplay::stats(TraceOp op) const {
+    return opStats[static_cast<size_t>(op)];
+}
+
+size_t TraceReplay::checked() const {
+    return finalChecked;
+}
+
+size_t TraceReplay::mismatches() const {
+    return finalMismatched;
+}
+
+void TraceReplay::report(std::ostream& os) const {
+    for (size_t i = 0; i < opStats.size(); ++i) {
+        const OpStats& st = opStats[i];
+        if (st.count == 0)
+            continue;
+        auto percentile = [&st](double q) {         // Upper edge of the bucket holding quantile q
+            size_t seen = 0;
+            for (size_t b = 0; b < st.buckets.size(); ++b) {
+                seen += st.buckets[b];
+                if (seen >= q * st.count) return uint64_t(1) << (b + 1);
+            }
+            return uint64_t(1) << st.buckets.size();
+        };
+        os << "  " << std::left << std::setw(24) << traceOpName(static_cast<TraceOp>(i)) << std::right
+           << std::setw(10) << st.count << " calls" << std::setw(9) << st.totalNs / st.count << " ns mean"
+           << "   p50 < " << percentile(0.5) << " ns   p99 < " << percentile(0.99) << " ns";
+        if (st.errors) os << "   (" << st.errors << " threw)";
+        os << std::endl;
+
+        size_t peak = *std::max_element(st.buckets.begin(), st.buckets.end());
+        for (size_t b = 0; b < st.buckets.size(); ++b) {
+            if (st.buckets[b] == 0) continue;
+            os << "      < " << std::setw(10) << (uint64_t(1) << (b + 1)) << " ns " << std::setw(10)
+               << st.buckets[b] << " " << std::string((st.buckets[b] * 40 + peak - 1) / peak, '#') << std::endl;
+        }
+    }
+    os << "Final state: " << finalChecked << " sequences checked, " << finalMismatched << " differ" << std::endl;
+}
@@ -0,0 +1,168 @@
+#ifndef SEQUENCE_TRACE_H
+#define SEQUENCE_TRACE_H
+
+#include <cstdint>                  // Provides fixed-width integers for the trace format
+#include <initializer_list>         // Provides the numeric operand list of a record
+#include <iostream>
+#include <map>                      // Provides the snapshot ordinal table
+#include <string>                   // Provides std::string class
+#include <unordered_map>            // Provides the object id table
+#include <vector>                   // Provides histogram buckets
+#include "Sequence.h"               // Provides the Sequence being traced
+// SequenceTrace - Opt-in binary trace of the operations performed on Sequences
+//
+// Sequence.cpp only calls the record hook when it is built with SEQUENCE_TRACE,
+// and the hook writes nothing until start() is called, so normal builds pay
+// nothing. A trace is the magic "SEQTRACE" and a version byte, followed by
+// records: an opcode byte, then LEB128 varints (object ids, positions,
+// counts) and length-prefixed strings. Sequences get ids in the order they
+// are first seen. A Sequence that existed before start() is written out
+// whole (a Load record) the first time it is touched. stop() writes a Final
+// record for every live Sequence with its size and a hash of its contents,
+// so a replay can check that it ended in the same state.
+//
+// Writes through a reference from operator[] are recorded as a Store when
+// the next operation starts. Writes made after a later operation are missed,
+// and the final check reports them. size(), empty(), capacity() and
+// in_transaction() change nothing and are not recorded. snapshot() is
+// recorded so that a rollback to it can name it by its per-Sequence ordinal;
+// a handle taken before start() (or from another Sequence) has no ordinal
+// and replays as an invalid snapshot.
+//
+// Sequences on different threads stay independent in a SEQUENCE_TRACE build:
+// the call nesting and the pending operator[] write are tracked per thread.
+// Recording itself is single-threaded: call start() and stop() while no other
+// thread is using Sequences, and in between only the thread that called
+// start() may use them.
+
+enum class TraceOp : uint8_t {
+    Construct,                                      // id, size
+    Copy,                                           // id, source id
+    Move,                                           // id, source id
+    CopyAssign,                                     // id, source id
+    MoveAssign,                                     // id, source id
+    Destroy,                                        // id
+    Load,                                           // id, size, capacity, n, then n (position, item) pairs
+    Index,                                          // id, position
+    Store,                                          // id, item written through the last Index reference
+    PushBack,                                       // id, item
+    PopBack,                                        // id
+    PushFront,                                      // id, item
+    PopFront,                                       // id
+    Insert,                                         // id, position, item
+    Erase,                                          // id, position, count
+    Clear,                                          // id
+    Append,                                         // id, other id
+    SetCapacity,                                    // id, capacity
+    Reverse,                                        // id
+    Rotate,                                         // id, k
+    Sort,                                           // id
+    Merge,                                          // id, other id
+    InsertSorted,                                   // id, item
+    Begin,                                          // id
+    Commit,                                         // id
+    Rollback,                                       // id
+    RollbackTo,                                     // id, snapshot ordinal (noSnapshot if unknown)
+    Snapshot,                                       // id (the nth Snapshot of id has ordinal n)
+    At,                                             // id, position
+    Front,                                          // id
+    Back,                                           // id
+    Find,                                           // id, from, item
+    PositionsWithLength,                            // id, length
+    PositionsWithPrefix,                            // id, prefix
+    Print,                                          // id
+    Final,                                          // id, size, contents hash
+    Count                                           // Number of opcodes
+};
+
+const char* traceOpName(TraceOp op);                // Printable name of an opcode
+
+class SequenceTrace {
+public:
+    static void start(std::ostream& out);           // Begins recording into out (which must outlive stop())
+    static void stop();                             // Writes Final records and stops recording
+    static bool recording();                        // True between start() and stop()
+
+    // Marks one public call. Only the outermost call is recorded, so public
+    // members that delegate to each other (insert -> push_back) appear once.
+    class Scope {
+    public:
+        Scope() : outermost(depth++ == 0 && out != nullptr) {}
+        ~Scope() { --depth; }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        bool outer() const { return outermost; }
+    private:
+        bool outermost;
+    };
+
+    // Appends one record for s. Construct/Copy give s a fresh id; other ops adopt s if it is new.
+    static void record(TraceOp op, const Sequence* s, std::initializer_list<uint64_t> args = {},
+                       const std::string* text = nullptr);
+    static void recordMove(const Sequence* s, const Sequence* source); // Move construction of s, once it is complete
+    static void trackStore(const Sequence* s, std::string& item); // Remembers the item operator[] returned
+    static void recordSnapshot(const Sequence* s, const Sequence::Snapshot& snap); // Records snapshot() of s, which returned snap
+    static uint64_t snapshotOf(const Sequence* s, const Sequence::Snapshot& snap); // Ordinal of snap, or noSnapshot
+    static const uint64_t noSnapshot = ~uint64_t(0);
+    static uint64_t idOf(const Sequence* s);        // Id of s, writing a Load record first if it is new
+
+    static uint64_t fingerprint(const Sequence& s); // Hash of the contents in order (gaps count as "")
+
+    // Trace encoding shared with the replayer
+    static void writeVarint(std::ostream& out, uint64_t value);
+    static uint64_t readVarint(std::istream& in);   // Throws on a truncated trace
+    static void writeString(std::ostream& out, const std::string& text);
+    static std::string readString(std::istream& in);
+
+private:
+    static std::ostream* out;                       // Destination while recording, null otherwise
+    static thread_local int depth;                  // Public calls currently on this thread's stack
+    static std::unordered_map<const Sequence*, uint64_t> ids; // Live Sequences seen so far
+    static uint64_t nextId;
+    static thread_local std::string* pendingItem;   // Item returned by the last operator[]
+    static thread_local std::string pendingValue;   // Its value at that time
+    static thread_local uint64_t pendingOwner;      // Id of the Sequence it belongs to
+    struct Snapshots {
+        uint64_t taken = 0;                         // snapshot() calls recorded so far
+        std::map<std::pair<size_t, size_t>, uint64_t> byMark; // Newest ordinal for each (mark, generation)
+    };
+    static std::unordered_map<const Sequence*, Snapshots> snapshots; // Per live Sequence
+
+    static void forget(const Sequence* s);          // Drops the snapshots of a Sequence that gets a new id
+
+    static void flushStore();                       // Records a write through the last operator[] reference
+    template <typename Fn>
+    static void visit(const Sequence& s, Fn&& fn);  // Calls fn(position, item) for each item of s in order
+};
+
+// TraceReplay - re-executes a trace on fresh Sequences and times every operation
+class TraceReplay {
+public:
+    struct OpStats {
+        size_t count = 0;                           // Operations executed
+        size_t errors = 0;                          // Operations that threw (as they did when recorded)
+        uint64_t totalNs = 0;
+        std::vector<size_t> buckets;                // buckets[i] counts calls taking [2^i, 2^(i+1)) ns
+    };
+
+    explicit TraceReplay(std::istream& in);         // Reads and checks the header
+    void run();                                     // Executes every record (throws on a malformed trace)
+    const OpStats& stats(TraceOp op) const;
+    size_t checked() const;                         // Final records compared
+    size_t mismatches() const;                      // Final records whose Sequence ended up different
+    void report(std::ostream& os) const;            // Per-operation latency histograms
+
+private:
+    std::istream& in;
+    std::unordered_map<uint64_t, Sequence> objects; // Replayed Sequences by trace id
+    std::string* lastRef;                           // Reference returned by the last Index
+    std::unordered_map<uint64_t, std::vector<Sequence::Snapshot>> snapshots; // Handles by trace id, in ordinal order
+    std::vector<OpStats> opStats;
+    size_t finalChecked;
+    size_t finalMismatched;
+
+    Sequence& object(uint64_t id);                  // Throws if the trace uses an unknown id
+    void execute(TraceOp op);                       // Reads the operands of one record and runs it
+};
+
+#endif // SEQUENCE_TRACE_H